@@ -0,0 +1,14 @@
+// Maps shared by the benchmarks: the shipped levels and generated open and
+// maze-like maps of any size
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include <utility>
+#include <vector>
+
+TileGrid loadLevel(const char *filePath);
+TileGrid generateOpenMap(int size, int wallPercent, unsigned int seed);
+TileGrid generateMaze(int size, unsigned int seed);
+std::vector<std::pair<int, int>> generateQueries(TileGrid *grid, int count,
+                                                 unsigned int seed);
@@ -0,0 +1,126 @@
+// Maps shared by the benchmarks: the shipped levels and generated open and
+// maze-like maps of any size
+
+#include "BenchMaps.hpp"
+#include "Maze/LevelData.hpp"
+#include "Maze/TileGrid.hpp"
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * Loads a level file, keeping only its walls.
+ *
+ * @param filePath The path to the level file.
+ * @return The grid of walls described by the file.
+ */
+TileGrid loadLevel(const char *filePath) {
+    LevelData level;
+    level.loadText(filePath);
+    return level.map;
+}
+
+/**
+ * Generates an open map with a border and randomly scattered walls.
+ *
+ * @param size Number of tiles along each axis.
+ * @param wallPercent Chance of each inner tile being a wall.
+ * @param seed Seed for the random number generator.
+ * @return The generated grid.
+ */
+TileGrid generateOpenMap(int size, int wallPercent, unsigned int seed) {
+    std::mt19937 random(seed);
+    TileGrid grid(size, size);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            bool isBorder = x == 0 || y == 0 || x == size - 1 || y == size - 1;
+            grid.setWall(x, y, isBorder || int(random() % 100) < wallPercent);
+        }
+    }
+
+    return grid;
+}
+
+/**
+ * Generates a perfect maze with one-tile corridors using a randomized
+ * depth-first search. Every other row and column holds the corridor cells.
+ *
+ * @param size Number of tiles along each axis. Should be odd.
+ * @param seed Seed for the random number generator.
+ * @return The generated grid.
+ */
+TileGrid generateMaze(int size, unsigned int seed) {
+    std::mt19937 random(seed);
+    TileGrid grid(size, size);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            grid.setWall(x, y, true);
+        }
+    }
+
+    const int xDirections[] = {2, -2, 0, 0};
+    const int yDirections[] = {0, 0, -2, 2};
+
+    std::vector<std::pair<int, int>> stack = {{1, 1}};
+    grid.setWall(1, 1, false);
+
+    while (!stack.empty()) {
+        int x = stack.back().first;
+        int y = stack.back().second;
+
+        // Collect the neighbouring cells that have not been carved yet
+        int options[4];
+        int numOptions = 0;
+        for (int i = 0; i < 4; i++) {
+            int xNew = x + xDirections[i], yNew = y + yDirections[i];
+            if (xNew > 0 && xNew < size - 1 && yNew > 0 && yNew < size - 1 &&
+                grid.isWall(xNew, yNew)) {
+                options[numOptions++] = i;
+            }
+        }
+
+        if (numOptions == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        // Carve through the wall between the cells and continue from there
+        int i = options[random() % numOptions];
+        grid.setWall(x + xDirections[i] / 2, y + yDirections[i] / 2, false);
+        grid.setWall(x + xDirections[i], y + yDirections[i], false);
+        stack.push_back({x + xDirections[i], y + yDirections[i]});
+    }
+
+    return grid;
+}
+
+/**
+ * Picks random pairs of open tiles to search between.
+ *
+ * @param grid The grid to pick tiles from.
+ * @param count Number of queries to pick.
+ * @param seed Seed for the random number generator.
+ * @return The start and goal tile indices of every query.
+ */
+std::vector<std::pair<int, int>> generateQueries(TileGrid *grid, int count,
+                                                 unsigned int seed) {
+    std::mt19937 random(seed);
+    std::vector<int> openTiles;
+
+    for (int y = 0; y < grid->getHeight(); y++) {
+        for (int x = 0; x < grid->getWidth(); x++) {
+            if (!grid->isWall(x, y))
+                openTiles.push_back(grid->toIndex(x, y));
+        }
+    }
+
+    std::vector<std::pair<int, int>> queries;
+    for (int i = 0; i < count && !openTiles.empty(); i++) {
+        queries.push_back({openTiles[random() % openTiles.size()],
+                           openTiles[random() % openTiles.size()]});
+    }
+
+    return queries;
+}
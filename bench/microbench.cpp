@@ -0,0 +1,649 @@
+// Microbenchmarks of the game's hot paths: pathfinding, wall-bound movement,
+// sprite collision, finding entities near a point, loading, constructing and
+// simulating levels, and text rendering. Each
+// benchmark is timed in samples of many operations, and the results are
+// written to stdout as JSON so that runs can be compared
+
+#include "BenchMaps.hpp"
+#include "Entities/EntityStorage.hpp"
+#include "Entities/WallBoundEntity.hpp"
+#include "Game/Level.hpp"
+#include "Game/LevelLoader.hpp"
+#include "Maze/LevelData.hpp"
+#include "Maze/TileGrid.hpp"
+#include "UI/RenderedText.hpp"
+#include "UI/Sprite.hpp"
+#include "Util/Arena.hpp"
+#include "Util/Constants.hpp"
+#include "Util/FontCache.hpp"
+#include "Util/GlyphAtlas.hpp"
+#include "Util/Input.hpp"
+#include "Util/Pathfinding.hpp"
+#include "Util/SpatialHash.hpp"
+#include "Util/SpriteBatch.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Samples are made of enough operations to take at least this long, so that
+// the cost of reading the clock does not matter
+const double TARGET_SAMPLE_NS = 20000;
+
+// Most operations in one sample, for operations too fast to reach the target
+const long long MAX_SAMPLE_OPS = 1 << 24;
+
+// Time spent taking samples of each benchmark, and limits on their number
+const double BENCHMARK_NS = 250e6;
+const int MIN_SAMPLES = 31;
+const int MAX_SAMPLES = 2000;
+
+// Number of entities moved together by the EntityStorage move benchmarks
+const int NUM_HORDE_BODIES = 1024;
+
+// Number of heap allocations, and bytes allocated, since the program started
+size_t allocationCount = 0;
+size_t allocatedBytes = 0;
+
+// Results are accumulated here so that the benchmarked work is not optimized
+// away
+volatile long long sink = 0;
+
+void *operator new(size_t size) {
+    allocationCount++;
+    allocatedBytes += size;
+
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == NULL)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete[](void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t) noexcept { free(memory); }
+
+// Timing and allocations of one benchmark. Times are per operation
+struct BenchResult {
+    std::string name;
+    int samples;
+    long long opsPerSample;
+    double meanNs;
+    double minNs;
+    double p50Ns;
+    double p90Ns;
+    double p99Ns;
+    double maxNs;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+// Every benchmark run so far
+std::vector<BenchResult> results;
+
+// Only benchmarks whose names contain this are run
+const char *filter = "";
+
+/**
+ * Gets the time since an earlier point.
+ *
+ * @param begin The earlier point.
+ * @return The time since it in nanoseconds.
+ */
+double getElapsedNs(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - begin)
+        .count();
+}
+
+/**
+ * Gets a percentile of sorted values, using the nearest rank.
+ *
+ * @param sorted The values, in ascending order.
+ * @param percent The percentile to get, from 0 to 100.
+ * @return The value at that percentile.
+ */
+double getPercentile(const std::vector<double> &sorted, double percent) {
+    size_t rank = ceil(percent / 100 * sorted.size());
+    return sorted[std::max(rank, size_t(1)) - 1];
+}
+
+/**
+ * Times an operation. It is first run in growing batches until a batch is long
+ * enough to time accurately, which also warms up caches and lazily sized
+ * arrays. Batches of that size are then timed as the samples.
+ *
+ * @param name Name of the benchmark.
+ * @param operation Called with the number of operations run before it, and
+ * runs the operation once.
+ */
+template <typename Operation>
+void runBenchmark(const std::string &name, Operation operation) {
+    if (name.find(filter) == std::string::npos)
+        return;
+
+    long long next = 0;
+    long long batch = 1;
+    double batchNs;
+
+    while (true) {
+        auto begin = std::chrono::steady_clock::now();
+        for (long long i = 0; i < batch; i++) {
+            operation(next++);
+        }
+        batchNs = getElapsedNs(begin);
+
+        if (batchNs >= TARGET_SAMPLE_NS || batch >= MAX_SAMPLE_OPS)
+            break;
+
+        batch *= 2;
+    }
+
+    int numSamples = std::max(
+        MIN_SAMPLES,
+        std::min(MAX_SAMPLES, int(BENCHMARK_NS / std::max(batchNs, 1.0))));
+
+    std::vector<double> samples;
+    samples.reserve(numSamples);
+
+    size_t allocationsBefore = allocationCount;
+    size_t bytesBefore = allocatedBytes;
+
+    for (int sample = 0; sample < numSamples; sample++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (long long i = 0; i < batch; i++) {
+            operation(next++);
+        }
+        samples.push_back(getElapsedNs(begin) / batch);
+    }
+
+    double totalOps = double(numSamples) * batch;
+
+    BenchResult result;
+    result.name = name;
+    result.samples = numSamples;
+    result.opsPerSample = batch;
+    result.allocsPerOp = (allocationCount - allocationsBefore) / totalOps;
+    result.bytesPerOp = (allocatedBytes - bytesBefore) / totalOps;
+
+    result.meanNs = 0;
+    for (double sample : samples) {
+        result.meanNs += sample;
+    }
+    result.meanNs /= numSamples;
+
+    std::sort(samples.begin(), samples.end());
+    result.minNs = samples.front();
+    result.p50Ns = getPercentile(samples, 50);
+    result.p90Ns = getPercentile(samples, 90);
+    result.p99Ns = getPercentile(samples, 99);
+    result.maxNs = samples.back();
+
+    fprintf(stderr, "%-40s %12.1f ns/op  p99 %12.1f  %8.2f allocs/op\n",
+            name.c_str(), result.meanNs, result.p99Ns, result.allocsPerOp);
+
+    results.push_back(result);
+}
+
+/**
+ * Writes every result to stdout as JSON.
+ */
+void printResults() {
+    printf("{\n  \"benchmarks\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &result = results[i];
+        printf("    {\"name\": \"%s\", \"samples\": %d, "
+               "\"ops_per_sample\": %lld, \"ns_per_op\": %.2f, "
+               "\"min_ns\": %.2f, \"p50_ns\": %.2f, \"p90_ns\": %.2f, "
+               "\"p99_ns\": %.2f, \"max_ns\": %.2f, \"allocs_per_op\": %.4f, "
+               "\"bytes_per_op\": %.2f}%s\n",
+               result.name.c_str(), result.samples, result.opsPerSample,
+               result.meanNs, result.minNs, result.p50Ns, result.p90Ns,
+               result.p99Ns, result.maxNs, result.allocsPerOp,
+               result.bytesPerOp, i + 1 < results.size() ? "," : "");
+    }
+
+    printf("  ]\n}\n");
+}
+
+// A named map to benchmark on
+struct BenchMap {
+    std::string name;
+    TileGrid grid;
+};
+
+/**
+ * Benchmarks finding a whole path with A* between random open tiles.
+ *
+ * @param maps The maps to search.
+ */
+void benchFindPath(std::vector<BenchMap> &maps) {
+    PathSearch search;
+    std::vector<int> path;
+
+    for (BenchMap &map : maps) {
+        std::vector<std::pair<int, int>> queries =
+            generateQueries(&map.grid, 256, 42);
+
+        runBenchmark("findPath/" + map.name, [&](long long i) {
+            const std::pair<int, int> &query = queries[i % queries.size()];
+            search.findPath(query.first, query.second, &map.grid, &path);
+            sink += path.size();
+        });
+    }
+}
+
+// Exposes the movement of a WallBoundEntity to the benchmark
+class BenchEntity : public WallBoundEntity {
+  public:
+    BenchEntity(float posX, float posY, TileGrid *map)
+        : WallBoundEntity(posX, posY, 16, 16, 0, 0, map, NULL, NULL) {}
+
+    using WallBoundEntity::move;
+};
+
+/**
+ * Benchmarks moving entities through a map in random directions, sliding
+ * along and stopping at walls: one entity on its own, and a horde of them
+ * moved together from an EntityStorage.
+ *
+ * @param maps The maps to move through.
+ */
+void benchMove(std::vector<BenchMap> &maps) {
+    // Directions at the player's speed, picked from in turn
+    std::mt19937 random(7);
+    std::vector<Vector2f> velocities;
+    for (int i = 0; i < 256; i++) {
+        float angle = 2 * M_PI * (random() % 360) / 360;
+        velocities.push_back(Vector2f{.x = PLAYER_BASE_VELOCITY * cosf(angle),
+                                      .y = PLAYER_BASE_VELOCITY * sinf(angle)});
+    }
+
+    for (BenchMap &map : maps) {
+        std::pair<int, int> start = generateQueries(&map.grid, 1, 7)[0];
+        int width = map.grid.getWidth();
+        BenchEntity entity((start.first % width) * TILE_SIZE,
+                           (start.first / width) * TILE_SIZE, &map.grid);
+
+        runBenchmark("move/" + map.name, [&](long long i) {
+            // Keep heading the same way for a while, as entities do
+            *entity.getVelocity() = velocities[(i / 16) % velocities.size()];
+            entity.move();
+            sink += entity.getPosition()->x;
+        });
+
+        std::vector<std::pair<int, int>> spawns =
+            generateQueries(&map.grid, NUM_HORDE_BODIES, 7);
+        EntityStorage bodies;
+        TextureRegion sprite = TextureRegion{NULL, SDL_Rect{0, 0, 0, 0}};
+        for (std::pair<int, int> &spawn : spawns) {
+            bodies.create((spawn.first % width) * TILE_SIZE,
+                          (spawn.first / width) * TILE_SIZE, 16, 16, sprite,
+                          ENTITY_LAYER);
+        }
+
+        std::string name = "EntityStorage::move/" + map.name + " x" +
+                           std::to_string(NUM_HORDE_BODIES);
+
+        runBenchmark(name, [&](long long i) {
+            // Every entity heads its own way, as in a horde
+            for (int j = 0; j < NUM_HORDE_BODIES; j++) {
+                Vector2f velocity =
+                    velocities[(i / 16 + j) % velocities.size()];
+                bodies.setVelocity(j, velocity.x, velocity.y);
+            }
+
+            bodies.savePreviousPositions();
+            bodies.move(&map.grid);
+            sink += bodies.getX(0);
+        });
+    }
+}
+
+/**
+ * Benchmarks checking pairs of sprites scattered over a level-sized area for
+ * overlap.
+ */
+void benchIsCollidingWith() {
+    std::mt19937 random(11);
+    std::vector<Sprite> sprites;
+    for (int i = 0; i < 1024; i++) {
+        sprites.push_back(Sprite(random() % int(VIEW_PIXEL_SIZE),
+                                 random() % int(VIEW_PIXEL_SIZE), 16, 16, NULL,
+                                 NULL));
+    }
+
+    runBenchmark("isCollidingWith/sprites", [&](long long i) {
+        Sprite &a = sprites[i & 1023];
+        Sprite &b = sprites[(i * 7 + 1) & 1023];
+        sink += a.isCollidingWith(&b);
+    });
+}
+
+/**
+ * Benchmarks finding which of many keys scattered over a map touch a box the
+ * size of the player, by checking every key in turn and by querying a spatial
+ * hash.
+ *
+ * @param maps The maps to scatter keys over.
+ */
+void benchOverlap(std::vector<BenchMap> &maps) {
+    for (BenchMap &map : maps) {
+        std::vector<std::pair<int, int>> spawns =
+            generateQueries(&map.grid, 2048, 17);
+        int width = map.grid.getWidth();
+
+        EntityStorage keys;
+        SpatialHash keyHash;
+        keyHash.setBounds(width * TILE_SIZE, map.grid.getHeight() * TILE_SIZE);
+
+        // Keys on the first tile of each pair, boxes searched on the second
+        std::vector<Vector2f> boxes;
+        for (const std::pair<int, int> &spawn : spawns) {
+            float x = (spawn.first % width) * TILE_SIZE;
+            float y = (spawn.first / width) * TILE_SIZE;
+            EntityHandle key =
+                keys.create(x, y, TILE_SIZE, TILE_SIZE,
+                            TextureRegion{NULL, SDL_Rect{0, 0, 0, 0}},
+                            KEY_LAYER);
+            keyHash.insert(key.slot, x, y, TILE_SIZE, TILE_SIZE);
+
+            float boxX = (spawn.second % width) * TILE_SIZE;
+            float boxY = (spawn.second / width) * TILE_SIZE;
+            boxes.push_back(Vector2f{.x = boxX, .y = boxY});
+        }
+
+        runBenchmark("overlap/every key " + map.name, [&](long long i) {
+            const Vector2f &box = boxes[i % boxes.size()];
+            int found = -1;
+            for (int k = 0; k < keys.getSize() && found == -1; k++) {
+                float x = keys.getX(k);
+                float y = keys.getY(k);
+                if (y + TILE_SIZE > box.y && y < box.y + TILE_SIZE &&
+                    x + TILE_SIZE > box.x && x < box.x + TILE_SIZE) {
+                    found = k;
+                }
+            }
+            sink += found;
+        });
+
+        ArenaVector<int> nearby;
+        runBenchmark("overlap/SpatialHash " + map.name, [&](long long i) {
+            const Vector2f &box = boxes[i % boxes.size()];
+            nearby.clear();
+            keyHash.query(box.x, box.y, TILE_SIZE, TILE_SIZE, &nearby);
+            sink += nearby.size();
+        });
+    }
+}
+
+/**
+ * Benchmarks picking up a key out of thousands, as a level does, and putting
+ * a new one in its place so that the number of keys stays the same.
+ */
+void benchPickup() {
+    TextureRegion sprite = TextureRegion{NULL, SDL_Rect{0, 0, 0, 0}};
+    std::mt19937 random(19);
+
+    EntityStorage keys;
+    for (int i = 0; i < 4096; i++) {
+        keys.create(random() % 4096, random() % 4096, TILE_SIZE, TILE_SIZE,
+                    sprite, KEY_LAYER);
+    }
+
+    runBenchmark("EntityStorage::remove/4096 keys", [&](long long i) {
+        int index = random() % keys.getSize();
+        float x = keys.getX(index);
+        float y = keys.getY(index);
+
+        keys.remove(keys.getHandle(index));
+        EntityHandle key =
+            keys.create(x, y, TILE_SIZE, TILE_SIZE, sprite, KEY_LAYER);
+        sink += key.slot;
+    });
+}
+
+/**
+ * Builds a prepared level over a map, with the player, followers and keys on
+ * random open tiles.
+ *
+ * @param map The map to use.
+ * @param numKeys Number of keys to place.
+ * @param numFollowers Number of followers to place.
+ * @return The prepared level.
+ */
+PreparedLevel generateLevel(const TileGrid &map, int numKeys,
+                            int numFollowers) {
+    PreparedLevel prepared;
+    prepared.data.map = map;
+
+    TileGrid grid = map;
+    std::vector<std::pair<int, int>> spawns =
+        generateQueries(&grid, std::max(numKeys + 1, numFollowers), 13);
+
+    int width = map.getWidth();
+    prepared.data.player =
+        LevelSpawn{spawns[0].first % width, spawns[0].first / width};
+
+    for (int i = 0; i < numFollowers; i++) {
+        prepared.data.followers.push_back(
+            LevelSpawn{spawns[i].second % width, spawns[i].second / width});
+    }
+
+    for (int i = 1; i <= numKeys; i++) {
+        prepared.data.keys.push_back(
+            LevelSpawn{spawns[i].first % width, spawns[i].first / width});
+    }
+
+    return prepared;
+}
+
+/**
+ * Benchmarks reading levels from their text source and their compiled files,
+ * and constructing a headless Level from a prepared one. Levels are
+ * constructed in an arena that is reset afterwards, as the game does.
+ *
+ * @param maps Generated maps to construct levels over, besides the shipped
+ * levels.
+ */
+void benchLevels(std::vector<BenchMap> &maps) {
+    for (int i = 1; i <= NUM_LEVELS; i++) {
+        std::string name = "level" + std::to_string(i);
+        std::string textPath = "res/levels/" + name + ".txt";
+        std::string filePath = LevelLoader::getLevelPath(i);
+
+        LevelData data;
+        runBenchmark("LevelData::loadText/" + name, [&](long long) {
+            data.loadText(textPath.c_str());
+            sink += data.keys.size();
+        });
+
+        runBenchmark("LevelData::load/" + name, [&](long long) {
+            data.load(filePath.c_str());
+            sink += data.keys.size();
+        });
+    }
+
+    std::vector<std::pair<std::string, PreparedLevel>> levels;
+    for (int i = 1; i <= NUM_LEVELS; i++) {
+        levels.emplace_back("level" + std::to_string(i), PreparedLevel());
+        levels.back().second.load(LevelLoader::getLevelPath(i).c_str());
+    }
+    for (BenchMap &map : maps) {
+        levels.emplace_back(map.name, generateLevel(map.grid, 1000, 1));
+    }
+
+    Arena arena;
+    for (auto &level : levels) {
+        // The map is copied out of the prepared level, so it can be reused.
+        // Large maps plan hierarchically, which would move the graph out
+        level.second.isHierarchical = false;
+
+        runBenchmark("Level::Level/" + level.first, [&](long long) {
+            Level *constructed =
+                arena.create<Level>(&level.second, nullptr, &arena);
+            sink += constructed->getNumKeys();
+            constructed->~Level();
+            arena.reset();
+        });
+    }
+}
+
+/**
+ * Benchmarks simulating ticks of a headless level with a single follower and
+ * with a horde of them, closing in on the player. A single follower keeps a
+ * search of its own, while a horde shares one flow field and plans across the
+ * thread pool. The player either stands still, so the horde's field is built
+ * once, or wanders about driven by a bot, so the field is rebuilt every time
+ * the player reaches a new tile. The level starts over whenever the player is
+ * caught.
+ *
+ * @param maps The maps to simulate levels on.
+ */
+void benchHorde(std::vector<BenchMap> &maps) {
+    for (BenchMap &map : maps) {
+        for (int numFollowers : {1, 32}) {
+            for (bool isWandering : {false, true}) {
+                PreparedLevel prepared =
+                    generateLevel(map.grid, 1, numFollowers);
+                Arena arena;
+                Level *level = nullptr;
+                RandomInput bot(7);
+
+                std::string name = "Level::update/" + map.name + " x" +
+                                   std::to_string(numFollowers) +
+                                   (isWandering ? " wandering" : "");
+
+                runBenchmark(name, [&](long long) {
+                    if (level == nullptr ||
+                        level->getState() != LevelState::Playing) {
+                        if (level != nullptr) {
+                            level->~Level();
+                            arena.reset();
+                        }
+
+                        level =
+                            arena.create<Level>(&prepared, nullptr, &arena);
+                    }
+
+                    level->update(isWandering ? bot.poll() : InputState{0});
+                    sink += level->getTickCount();
+                });
+
+                if (level != nullptr) {
+                    level->~Level();
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Benchmarks drawing text both ways the game does: rasterizing a changing
+ * string into a texture with SDL_ttf, and laying it out from a glyph atlas
+ * through the sprite batch. Text is drawn with a software renderer, so no
+ * display is needed.
+ */
+void benchText() {
+    if (TTF_Init() != 0) {
+        fprintf(stderr, "skipping text benchmarks: %s\n", SDL_GetError());
+        return;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(
+        0, VIEW_PIXEL_SIZE, VIEW_PIXEL_SIZE, 32, SDL_PIXELFORMAT_RGBA8888);
+    SDL_Renderer *renderer =
+        surface != NULL ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    GlyphAtlas atlas;
+
+    if (renderer == NULL || !atlas.build(renderer, FONT_PATH, 12)) {
+        fprintf(stderr, "skipping text benchmarks: %s\n", SDL_GetError());
+    } else {
+        RenderedText text("", 12, SDL_Color{255, 255, 255, 255});
+        char buffer[64];
+
+        runBenchmark("text/RenderedText", [&](long long i) {
+            snprintf(buffer, sizeof(buffer), "TIME %lld.%02lld", i / 100,
+                     i % 100);
+            text.setText(buffer);
+
+            int width, height;
+            sink += text.getTexture(renderer, &width, &height) != NULL;
+        });
+
+        SpriteBatch batch;
+        runBenchmark("text/GlyphAtlas", [&](long long i) {
+            snprintf(buffer, sizeof(buffer), "TIME %lld.%02lld", i / 100,
+                     i % 100);
+
+            int x = 0;
+            for (const char *c = buffer; *c != '\0'; c++) {
+                const GlyphAtlas::Glyph *glyph = atlas.getGlyph(*c);
+                SDL_Rect dst = SDL_Rect{x, 0, glyph->rect.w, glyph->rect.h};
+                batch.draw(atlas.getTexture(), glyph->rect, dst, HUD_LAYER);
+                x += glyph->advance;
+            }
+
+            batch.flush(renderer);
+            sink += x;
+        });
+    }
+
+    atlas.destroy();
+    FontCache::clear();
+    if (renderer != NULL) {
+        SDL_DestroyRenderer(renderer);
+    }
+    SDL_FreeSurface(surface);
+    TTF_Quit();
+}
+
+int main(int argc, char **argv) {
+    // Run only the benchmarks whose names contain the first argument
+    if (argc > 1) {
+        filter = argv[1];
+    }
+
+    std::vector<BenchMap> levelMaps;
+    for (int i = 1; i <= NUM_LEVELS; i++) {
+        LevelData data;
+        data.load(LevelLoader::getLevelPath(i).c_str());
+        levelMaps.push_back({"level" + std::to_string(i), data.map});
+    }
+
+    std::vector<BenchMap> largeMaps;
+    largeMaps.push_back({"maze 255x255", generateMaze(255, 3)});
+    largeMaps.push_back({"open 512x512", generateOpenMap(512, 20, 4)});
+
+    std::vector<BenchMap> allMaps = levelMaps;
+    allMaps.insert(allMaps.end(), largeMaps.begin(), largeMaps.end());
+
+    benchFindPath(allMaps);
+    benchMove(allMaps);
+    benchIsCollidingWith();
+    benchOverlap(largeMaps);
+    benchPickup();
+    benchLevels(largeMaps);
+
+    // Followers catch the player within moments on the shipped levels, which
+    // would mostly time restarting them
+    benchHorde(largeMaps);
+    benchText();
+
+    printResults();
+
+    return 0;
+}
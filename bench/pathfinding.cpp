@@ -0,0 +1,199 @@
+// Benchmark comparing A*, Jump Point Search and hierarchical pathfinding on
+// the shipped levels and on generated open and maze-like maps, and A* against
+// the incremental search while a follower chases a moving player
+
+#include "BenchMaps.hpp"
+#include "Maze/TileGrid.hpp"
+#include "Util/Constants.hpp"
+#include "Util/HierarchicalPathfinding.hpp"
+#include "Util/IncrementalPathSearch.hpp"
+#include "Util/JumpPointSearch.hpp"
+#include "Util/Pathfinding.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Number of start and goal pairs searched on every map
+const int NUM_QUERIES = 500;
+
+// Number of chases run on every map, and the most ticks each one lasts
+const int NUM_CHASES = 20;
+const int CHASE_TICKS = 480;
+
+// A named map to benchmark on
+struct BenchMap {
+    std::string name;
+    TileGrid grid;
+};
+
+// Gives a HierarchicalPathSearch the same interface as the flat searches
+struct HierarchicalSearch {
+    HierarchicalMap graph;
+    HierarchicalPathSearch search;
+
+    int findNextStep(int start, int goal, TileGrid *map) {
+        return this->search.findNextStep(start, goal, &this->graph);
+    }
+
+    int getExpandedCount() { return this->search.getExpandedCount(); }
+};
+
+/**
+ * Runs every query through a search and prints its cost.
+ *
+ * @param name Name of the algorithm to print.
+ * @param search The search to run.
+ * @param grid The grid to search.
+ * @param queries The start and goal tiles to search between.
+ */
+template <typename Search>
+void runQueries(const char *name, Search *search, TileGrid *grid,
+                const std::vector<std::pair<int, int>> &queries) {
+    // Warm up so that array growth is not measured
+    for (auto &query : queries) {
+        search->findNextStep(query.first, query.second, grid);
+    }
+
+    long long expanded = 0;
+    auto begin = std::chrono::steady_clock::now();
+
+    for (auto &query : queries) {
+        search->findNextStep(query.first, query.second, grid);
+        expanded += search->getExpandedCount();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double nanoseconds =
+        std::chrono::duration<double, std::nano>(end - begin).count();
+
+    printf("  %-6s %12.1f expansions/query %12.0f ns/query\n", name,
+           double(expanded) / queries.size(), nanoseconds / queries.size());
+}
+
+/**
+ * Runs chases between a follower and a player and prints the cost of a tick.
+ * Both move at their speeds in the game, so the player reaches a new tile
+ * twice as often as the follower, and the follower asks for its next step
+ * every tick as it does in the game. The player runs straight
+ * and turns at random, and a chase ends early once the follower catches it.
+ * Every chase gets a new search, so that searches which keep state between
+ * ticks start from nothing.
+ *
+ * @param name Name of the algorithm to print.
+ * @param grid The grid to chase on.
+ * @param queries The follower and player tiles each chase starts from.
+ */
+template <typename Search>
+void runChases(const char *name, TileGrid *grid,
+               const std::vector<std::pair<int, int>> &queries) {
+    const int xDirections[] = {1, -1, 0, 0};
+    const int yDirections[] = {0, 0, -1, 1};
+    const int playerTicksPerTile = TILE_SIZE / PLAYER_BASE_VELOCITY;
+    const int followerTicksPerTile = TILE_SIZE / FOLLOWER_BASE_VELOCITY;
+
+    std::mt19937 random(9);
+    int width = grid->getWidth();
+    long long expanded = 0;
+    long long ticks = 0;
+    double nanoseconds = 0;
+
+    for (int chase = 0; chase < NUM_CHASES; chase++) {
+        Search search;
+        int follower = queries[chase % queries.size()].first;
+        int player = queries[chase % queries.size()].second;
+        int direction = random() % 4;
+
+        for (int tick = 1; tick <= CHASE_TICKS; tick++) {
+            // Keep running the same way until blocked or turning at random
+            if (tick % playerTicksPerTile == 0) {
+                if (random() % 4 == 0) {
+                    direction = random() % 4;
+                }
+
+                for (int i = 0; i < 4; i++) {
+                    int d = (direction + i) % 4;
+                    int x = player % width + xDirections[d];
+                    int y = player / width + yDirections[d];
+                    if (!grid->isWall(x, y)) {
+                        player = grid->toIndex(x, y);
+                        direction = d;
+                        break;
+                    }
+                }
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            int step = search.findNextStep(follower, player, grid);
+            auto end = std::chrono::steady_clock::now();
+
+            nanoseconds +=
+                std::chrono::duration<double, std::nano>(end - begin).count();
+            expanded += search.getExpandedCount();
+            ticks++;
+
+            if (step == -1)
+                break;
+
+            if (tick % followerTicksPerTile == 0) {
+                follower = step;
+            }
+        }
+    }
+
+    printf("  %-6s %12.1f expansions/tick %12.0f ns/tick\n", name,
+           double(expanded) / ticks, nanoseconds / ticks);
+}
+
+int main(int argc, char **argv) {
+    std::vector<BenchMap> maps;
+    maps.push_back({"level1.txt", loadLevel("res/levels/level1.txt")});
+    maps.push_back({"level2.txt", loadLevel("res/levels/level2.txt")});
+    maps.push_back({"level3.txt", loadLevel("res/levels/level3.txt")});
+    maps.push_back({"open 256x256", generateOpenMap(256, 10, 1)});
+    maps.push_back({"maze 63x63", generateMaze(63, 2)});
+    maps.push_back({"maze 255x255", generateMaze(255, 3)});
+    maps.push_back({"open 512x512", generateOpenMap(512, 20, 4)});
+    maps.push_back({"maze 511x511", generateMaze(511, 5)});
+
+    PathSearch aStar;
+    JumpPointSearch jumpPoint;
+    HierarchicalSearch hierarchical;
+
+    for (BenchMap &map : maps) {
+        std::vector<std::pair<int, int>> queries =
+            generateQueries(&map.grid, NUM_QUERIES, 42);
+
+        printf("%s (%d queries)\n", map.name.c_str(), int(queries.size()));
+        runQueries("A*", &aStar, &map.grid, queries);
+        runQueries("JPS", &jumpPoint, &map.grid, queries);
+
+        // Hierarchical planning only pays off on maps much larger than a
+        // cluster, so the small levels are skipped
+        if (map.grid.getWidth() >= HIERARCHICAL_MIN_MAP_SIZE) {
+            auto begin = std::chrono::steady_clock::now();
+            hierarchical.graph.build(&map.grid, HIERARCHICAL_CLUSTER_SIZE);
+            auto end = std::chrono::steady_clock::now();
+
+            printf("  %-6s %12.1f ms to build\n", "HPA*",
+                   std::chrono::duration<double, std::milli>(end - begin)
+                       .count());
+            runQueries("HPA*", &hierarchical, &map.grid, queries);
+        }
+    }
+
+    // Starting from the same queries, the incremental search is measured as
+    // followers use it, with the player and the follower both on the move
+    for (BenchMap &map : maps) {
+        std::vector<std::pair<int, int>> queries =
+            generateQueries(&map.grid, NUM_QUERIES, 42);
+
+        printf("%s chase (%d chases)\n", map.name.c_str(), NUM_CHASES);
+        runChases<PathSearch>("A*", &map.grid, queries);
+        runChases<IncrementalPathSearch>("LPA*", &map.grid, queries);
+    }
+
+    return 0;
+}
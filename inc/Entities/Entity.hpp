@@ -13,6 +13,9 @@ class Entity : public Sprite {
     // Member variable to store the velocity of the entity
     Vector2f velocity;
 
+    // Position at the start of the current simulation tick
+    Vector2f previousPosition;
+
     virtual void move(); // Can be overridden by subclasses
 
   public:
@@ -20,4 +23,6 @@ class Entity : public Sprite {
            float velY, SDL_Texture *texture, Window *window);
 
     Vector2f *getVelocity();
+    void savePreviousPosition();
+    Vector2f getRenderPosition() override;
 };
@@ -0,0 +1,87 @@
+// Stores many simple entities such as keys and followers as parallel arrays,
+// one per component. Each pass over the entities (moving, colliding with
+// walls, drawing) only walks the arrays it needs, keeping the data it touches
+// contiguous. Entities are referred to by generational handles, which stay
+// valid while entities around them are removed and never mistake a newer
+// entity for one that was removed
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/TextureAtlas.hpp"
+#include "Util/Window.hpp"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Refers to one entity of an EntityStorage for as long as it exists
+struct EntityHandle {
+    // Slot the entity was given, which it keeps until it is removed. Slots are
+    // small and dense, so they can index arrays kept alongside the storage
+    int slot;
+
+    // Generation of the slot when the entity was given it
+    uint32_t generation;
+};
+
+class EntityStorage {
+  private:
+    // Slot of the entity at each index of the component arrays
+    ArenaVector<int> slots;
+
+    // Index of each slot's entity in the component arrays. Free slots instead
+    // hold the next free slot, or -1 after the last
+    ArenaVector<int> indices;
+
+    // Number of times each slot has been freed
+    ArenaVector<uint32_t> generations;
+
+    // First free slot to reuse, or -1 if every slot is taken
+    int freeSlot;
+
+    // Positions of the entities
+    ArenaVector<float> positionX;
+    ArenaVector<float> positionY;
+
+    // Positions of the entities at the start of the current simulation tick
+    ArenaVector<float> previousX;
+    ArenaVector<float> previousY;
+
+    // Distance each entity moves every tick
+    ArenaVector<float> velocityX;
+    ArenaVector<float> velocityY;
+
+    // Size of each entity's bounding box, which is also its drawn size
+    ArenaVector<float> width;
+    ArenaVector<float> height;
+
+    // Texture each entity is drawn with and the rectangle of it to draw.
+    // Textures are NULL for entities created without a window
+    ArenaVector<SDL_Texture *> textures;
+    ArenaVector<SDL_Rect> frames;
+
+    // Layer each entity is drawn on
+    ArenaVector<int> layers;
+
+  public:
+    EntityStorage(Arena *arena = nullptr);
+    EntityHandle create(float posX, float posY, float width, float height,
+                        TextureRegion sprite, int layer);
+    void remove(EntityHandle handle);
+    void clear();
+    void reserve(int count);
+    int getSize();
+
+    bool contains(EntityHandle handle);
+    int getIndex(EntityHandle handle);
+    EntityHandle getHandle(int index);
+    EntityHandle getHandleInSlot(int slot);
+
+    float getX(int index);
+    float getY(int index);
+    void setVelocity(int index, float velX, float velY);
+    void savePreviousPositions();
+    void move(TileGrid *map);
+    void render(Window *window);
+};
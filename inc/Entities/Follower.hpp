@@ -1,22 +1,61 @@
-// Code for Follower movement and actions
+// Code for Follower movement and actions. A follower only decides where to go;
+// its position, velocity and sprite live in an EntityStorage shared with the
+// rest of the horde, which moves and draws them all together
 
 #pragma once
 
+#include "Entities/EntityStorage.hpp"
 #include "Entities/Player.hpp"
-#include "Entities/WallBoundEntity.hpp"
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/FlowField.hpp"
+#include "Util/HierarchicalPathfinding.hpp"
+#include "Util/IncrementalPathSearch.hpp"
+#include "Util/JumpPointSearch.hpp"
+#include "Util/Pathfinding.hpp"
 
-class Follower : public WallBoundEntity {
+class Follower {
   private:
+    // Storage holding the follower's body, and the follower's index in it.
+    // Followers are never removed, so the index does not change
+    EntityStorage *bodies;
+    int index;
+
+    // Pointer to the grid of walls making up the map
+    TileGrid *map;
+
     // Pointer to the Player object that the Follower is following
     Player *player;
 
-    void updateVelocity();
+    // Strategy used to find the way to the player
+    PathfindingMode pathfindingMode;
+
+    // Search state reused every frame so that pathfinding does not allocate
+    PathSearch pathSearch;
+
+    // Search kept between frames for PathfindingMode::Incremental
+    IncrementalPathSearch incrementalSearch;
+
+    // Search state reused every frame for PathfindingMode::JumpPoint
+    JumpPointSearch jumpPointSearch;
+
+    // Search state reused every frame for PathfindingMode::Hierarchical
+    HierarchicalPathSearch hierarchicalSearch;
+
+    // Flow field towards the player shared by every follower in the level
+    FlowField *flowField;
+
+    // Graph of cluster entrances shared by every follower in the level
+    HierarchicalMap *hierarchicalMap;
+
+    int findNextTile(int followerTile, int playerTile);
 
   public:
-    Follower(Window *window);
-    Follower(float posX, float posY, float velX, float velY,
-             std::vector<std::vector<Tile>> *map, Player *player,
-             Window *window);
+    Follower(EntityStorage *bodies, int index, TileGrid *map, Player *player,
+             Arena *arena = nullptr);
 
-    void update() override;
+    void setPathfindingMode(PathfindingMode mode, FlowField *flowField,
+                            HierarchicalMap *hierarchicalMap);
+    int getTile();
+    void plan();
 };
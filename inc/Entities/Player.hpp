@@ -4,6 +4,7 @@
 
 #include "Entities/Entity.hpp"
 #include "Entities/WallBoundEntity.hpp"
+#include "Util/Input.hpp"
 #include <vector>
 
 class Player : public WallBoundEntity {
@@ -11,11 +12,14 @@ class Player : public WallBoundEntity {
     // Member variable to store the number of keys the player has
     int numKeys;
 
+    // Buttons held for the next tick
+    InputState input;
+
   public:
-    Player(Window *window);
     Player(float posX, float posY, float velX, float velY,
-           std::vector<std::vector<Tile>> *map, Window *window);
+           TileGrid *map, Window *window);
 
+    void setInput(const InputState &input);
     void update() override;
 
     int getNumKeys();
@@ -3,18 +3,20 @@
 #pragma once
 
 #include "Entities/Entity.hpp"
-#include "Maze/Tile.hpp"
-#include <vector>
+#include "Maze/TileGrid.hpp"
 
 class WallBoundEntity : public Entity {
   protected:
-    // Pointer to the 2D vector representing the Tile-based map
-    std::vector<std::vector<Tile>> *map;
+    // Pointer to the grid of walls making up the map
+    TileGrid *map;
 
+    bool isCollidingWithWall();
     void move() override;
 
   public:
     WallBoundEntity(float posX, float posY, float width, float height,
-                    float velX, float velY, std::vector<std::vector<Tile>> *map,
-                    SDL_Texture *texture, Window *window);
+                    float velX, float velY, TileGrid *map, SDL_Texture *texture,
+                    Window *window);
+
+    int getTile();
 };
@@ -2,8 +2,16 @@
 
 #pragma once
 
+#include "Game/Hud.hpp"
 #include "Game/Level.hpp"
+#include "Game/LevelLoader.hpp"
+#include "Game/ProfilerOverlay.hpp"
+#include "Game/Replay.hpp"
 #include "UI/Screen.hpp"
+#include "UI/Text.hpp"
+#include "Util/Arena.hpp"
+#include "Util/Input.hpp"
+#include "Util/SdlContext.hpp"
 #include "Util/Window.hpp"
 #include <map>
 #include <string>
@@ -11,6 +19,10 @@
 
 class Game {
   private:
+    // Keeps SDL running until every member below, which may hold SDL
+    // resources, has been destroyed
+    SdlContext sdl;
+
     // Member variable to track the running state of the game
     bool running;
 
@@ -30,19 +42,60 @@ class Game {
     // Map to store different screens using their unique names
     std::map<std::string, Screen *> screens;
 
-    // Unique pointer to the current level being played
-    std::unique_ptr<Level> currentLevel;
+    // Memory for everything belonging to the current level. It is reset
+    // rather than freed between levels, so it is reused by the next one
+    Arena levelArena;
+
+    // The current level being played, allocated from levelArena, or nullptr
+    Level *currentLevel;
 
     // Index representing the current level being played
     int currentLevelIndex;
 
-    void initSdl();
+    // Loads upcoming levels in the background
+    LevelLoader levelLoader;
+
+    // Message on the levels screen saying which level failed to load, owned by
+    // init
+    Text *levelErrorText;
+
+    // Display of keys, time and frame rate drawn over the level
+    Hud hud;
+
+#ifdef PROFILING
+    // Timings of the profiled scopes, toggled with F3
+    ProfilerOverlay profilerOverlay;
+#endif
+
+    // Source of the player's input while a level is played
+    KeyboardInput keyboard;
+
+    // File every level played is recorded to, or empty to not record
+    std::string recordPath;
+
+    // Input of the level being played, kept when recordPath is set
+    Replay recording;
+
+    // Whether a replay is being watched instead of the keyboard being read
+    bool isReplaying;
+
+    // The replay being watched and its playback
+    Replay replay;
+    ReplayInput replayInput;
+
+    void endLevel();
+    void finishSession();
     void handleEvents();
     void update();
     void render();
 
   public:
     Game(const char *name, unsigned int fps);
+    void setRecordPath(const char *filePath);
+    bool watchReplay(const char *filePath);
     void init();
+    static int runHeadless(int levelIndex, int maxTicks, unsigned int seed,
+                           const char *recordPath);
+    static int runReplay(const char *filePath);
     ~Game();
 };
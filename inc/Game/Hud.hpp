@@ -0,0 +1,29 @@
+// Heads-up display drawn over a level: keys collected, time spent in the
+// level and frames per second
+
+#pragma once
+
+#include "UI/GlyphText.hpp"
+#include "Util/Window.hpp"
+#include <SDL2/SDL.h>
+
+class Hud {
+  private:
+    // Lines of the display
+    GlyphText keysText;
+    GlyphText timeText;
+    GlyphText fpsText;
+
+    // Start of the period frames are being counted over, in milliseconds
+    Uint32 fpsStartTicks;
+
+    // Number of frames drawn since fpsStartTicks
+    int frameCount;
+
+    // Frames per second measured over the last full period
+    int fps;
+
+  public:
+    Hud(Window *window);
+    void update(int keysCollected, int numKeys, int levelTicks);
+};
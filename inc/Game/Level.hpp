@@ -3,37 +3,95 @@
 
 #pragma once
 
+#include "Entities/EntityStorage.hpp"
 #include "Entities/Follower.hpp"
 #include "Entities/Player.hpp"
-#include "Maze/Key.hpp"
-#include "Maze/Tile.hpp"
+#include "Game/LevelLoader.hpp"
+#include "Maze/TileGrid.hpp"
+#include "Maze/TileLayer.hpp"
+#include "Util/Arena.hpp"
 #include "Util/Constants.hpp"
+#include "Util/FlowField.hpp"
+#include "Util/HierarchicalPathfinding.hpp"
+#include "Util/Input.hpp"
+#include "Util/SpatialHash.hpp"
 #include "Util/Window.hpp"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+// Whether a level is still being played, and how it ended otherwise
+enum class LevelState { Playing, Won, Lost };
+
 class Level {
   private:
-    // 2D vector representing the Tile-based map of the level
-    std::vector<std::vector<Tile>> map;
+    // Grid recording which tiles of the level are walls
+    TileGrid map;
+
+    // Window the level is drawn to, or nullptr if it is simulated headless
+    Window *window;
+
+    // Walls and floor of the level, pre-rendered. Only created with a window
+    std::unique_ptr<TileLayer> tileLayer;
 
     // Number of keys within the level
     int numKeys;
 
-    // Vector to store Key objects in the level
-    std::vector<Key> keys;
+    // Keys left to collect in the level
+    EntityStorage keys;
+
+    // Keys left to collect, by their slot in keys
+    SpatialHash keyHash;
 
     // Player object representing the player character in the level
     Player player;
 
-    // Follower object representing an entity following the player in the level
-    Follower follower;
+    // Positions, velocities and sprites of the followers, moved and drawn
+    // together. Each follower's body has the same index as the follower
+    EntityStorage followerBodies;
 
-    void render();
+    // Followers chasing the player, one for every follower spawn in the level
+    ArenaVector<Follower> followers;
+
+    // Followers by their index in followers, moved along with them
+    SpatialHash followerHash;
+
+    // Ids found by the latest query of keyHash or followerHash
+    ArenaVector<int> nearby;
+
+    // Strategy the followers use to find their way to the player
+    PathfindingMode pathfindingMode;
+
+    // Distances to the player's tile, shared by every follower
+    FlowField flowField;
+
+    // Number of the map's wall changes the flow field was built with
+    int flowFieldChangeCount;
+
+    // Graph of cluster entrances for planning paths on large maps
+    HierarchicalMap hierarchicalMap;
+
+    // Number of simulation ticks since the level started
+    int tickCount;
+
+    // Whether the level has been won or lost yet
+    LevelState state;
+
+    void updateNavigation();
+    void updateFollowers();
+    void collectKeys();
+    bool isPlayerCaught();
+    void updateCamera();
 
   public:
-    Level(const char *filePath, Window *window);
+    Level(PreparedLevel *level, Window *window, Arena *arena);
     Player *getPlayer();
-    Follower *getFollower();
+    int getFollowerCount();
+    Follower *getFollower(int index);
     int getNumKeys();
-    void update();
+    int getTickCount();
+    LevelState getState();
+    uint64_t getChecksum();
+    void update(const InputState &input);
+    void render();
 };
@@ -0,0 +1,68 @@
+// Loads levels on a background thread ahead of time, so that starting a level
+// only has to create its sprites
+
+#pragma once
+
+#include "Maze/LevelData.hpp"
+#include "Util/HierarchicalPathfinding.hpp"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// A level read from disk along with the navigation data built for it, ready
+// to be moved into a Level
+struct PreparedLevel {
+    // Walls and spawn points of the level
+    LevelData data;
+
+    // Whether the level file was read and is valid. Levels that failed to
+    // load are still handed out, so the game can tell the player
+    bool isLoaded;
+
+    // Whether the followers plan their paths over hierarchicalMap
+    bool isHierarchical;
+
+    // Graph of cluster entrances, only built for large maps with one follower
+    HierarchicalMap hierarchicalMap;
+
+    PreparedLevel();
+    bool load(const char *filePath);
+};
+
+class LevelLoader {
+  private:
+    // Thread loading the requested levels one at a time
+    std::thread worker;
+
+    // Guards every member below
+    std::mutex mutex;
+
+    // Wakes the worker when a level is requested or the loader is stopping
+    std::condition_variable condition;
+
+    // Indices of the levels waiting to be loaded, in the order they will be
+    std::deque<int> requests;
+
+    // Index of the level the worker is loading, or -1
+    int loadingIndex;
+
+    // Loaded levels that have not been taken yet, keyed by index, including
+    // the ones that failed to load
+    std::map<int, std::unique_ptr<PreparedLevel>> loaded;
+
+    // Set to make the worker exit
+    bool isStopping;
+
+    void run();
+
+  public:
+    LevelLoader();
+    static std::string getLevelPath(int index);
+    void preload(int index);
+    std::unique_ptr<PreparedLevel> take(int index);
+    ~LevelLoader();
+};
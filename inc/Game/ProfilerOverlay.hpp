@@ -0,0 +1,34 @@
+// On-screen summary of the frame profiler: how long each profiled scope took
+// on average and at most over the last second. Only exists in builds with
+// PROFILING defined
+
+#pragma once
+
+#ifdef PROFILING
+
+#include "UI/GlyphText.hpp"
+#include "Util/Profiler.hpp"
+#include "Util/Window.hpp"
+#include <vector>
+
+class ProfilerOverlay {
+  private:
+    // Title line followed by one line per scope
+    std::vector<GlyphText> lines;
+
+    // Latest summary of the scopes, reused between refreshes
+    std::vector<ProfileStats> stats;
+
+    // When the lines were last refreshed, from Profiler::now
+    int64_t refreshTime;
+
+    // Whether the overlay is drawn
+    bool isVisible;
+
+  public:
+    ProfilerOverlay(Window *window);
+    void toggle();
+    void update();
+};
+
+#endif
@@ -0,0 +1,92 @@
+// Recording of the input a level was played with, tick by tick. Since levels
+// are deterministic, playing the same input back on the same level reproduces
+// the session exactly, which a checksum of the final state confirms
+
+#pragma once
+
+#include "Util/Input.hpp"
+#include <cstdint>
+#include <vector>
+
+// Header at the start of a replay file. It is followed by runCount runs of
+// input, each stored as the buttons held followed by the number of ticks they
+// were held for as a variable-length integer
+struct ReplayFileHeader {
+    // REPLAY_FILE_MAGIC, identifying the file as a replay
+    char magic[4];
+
+    // REPLAY_FILE_VERSION at the time the file was written
+    uint16_t version;
+
+    uint16_t reserved;
+
+    // Number of the level that was played, starting from 1
+    uint32_t levelIndex;
+
+    // Seed of any randomness in the session, such as a bot's input
+    uint32_t seed;
+
+    // Number of ticks recorded, and of runs they were stored in
+    uint32_t tickCount;
+    uint32_t runCount;
+
+    // Level::getChecksum at the end of the recording
+    uint64_t checksum;
+};
+
+// A stretch of consecutive ticks with the same buttons held
+struct ReplayRun {
+    InputState input;
+    int length;
+};
+
+class Replay {
+  private:
+    // Number of the level the input was recorded on
+    int levelIndex;
+
+    // Seed of any randomness in the session
+    uint32_t seed;
+
+    // Every tick's input, compressed into runs
+    std::vector<ReplayRun> runs;
+
+    // Number of ticks recorded
+    int tickCount;
+
+    // Checksum of the level's state after the last tick
+    uint64_t checksum;
+
+  public:
+    Replay();
+    void start(int levelIndex, uint32_t seed);
+    void record(InputState input);
+    void finish(uint64_t checksum);
+    bool save(const char *filePath) const;
+    bool load(const char *filePath);
+    bool verify(uint64_t checksum, int tickCount) const;
+
+    int getLevelIndex() const;
+    uint32_t getSeed() const;
+    int getTickCount() const;
+    uint64_t getChecksum() const;
+    int getRunCount() const;
+    const ReplayRun &getRun(int index) const;
+};
+
+// Input played back from a replay, one recorded tick per poll
+class ReplayInput : public InputSource {
+  private:
+    // Replay being played back
+    const Replay *replay;
+
+    // Run being played back, and how many of its ticks have been
+    int run;
+    int runTick;
+
+  public:
+    ReplayInput();
+    void start(const Replay *replay);
+    bool isFinished() const;
+    InputState poll() override;
+};
@@ -0,0 +1,67 @@
+// Everything needed to build a level: its walls and where the player, keys
+// and followers start. Levels are authored as text and compiled to a binary
+// format that is memory-mapped and copied straight into a TileGrid
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include <cstdint>
+#include <vector>
+
+// Tile a player, key or follower starts on
+struct LevelSpawn {
+    int x;
+    int y;
+};
+
+// Header at the start of a compiled level file. It is followed by the key
+// spawns, the follower spawns, the chunk table of the wall grid padded to a
+// multiple of 8 bytes, and finally the wall bits of every allocated chunk
+struct LevelFileHeader {
+    // LEVEL_FILE_MAGIC, identifying the file as a compiled level
+    char magic[4];
+
+    // LEVEL_FILE_VERSION at the time the file was written
+    uint16_t version;
+
+    // TileGrid::CHUNK_SHIFT of the grid the walls were written from
+    uint16_t chunkShift;
+
+    // Dimensions of the map in tiles
+    uint32_t width;
+    uint32_t height;
+
+    // Tile the player starts on. Files without a player on the map are not
+    // valid levels
+    int32_t playerX;
+    int32_t playerY;
+
+    // Number of entries in each spawn table
+    uint32_t keyCount;
+    uint32_t followerCount;
+
+    // Number of chunks with wall bits stored in the file
+    uint32_t chunkCount;
+
+    uint32_t reserved;
+};
+
+class LevelData {
+  public:
+    // Grid recording which tiles of the level are walls
+    TileGrid map;
+
+    // Tile the player starts on, or -1 if the level has no player
+    LevelSpawn player;
+
+    // Tiles the keys start on, in the order they appear in the file
+    std::vector<LevelSpawn> keys;
+
+    // Tiles the followers start on, in the order they appear in the file
+    std::vector<LevelSpawn> followers;
+
+    LevelData();
+    bool loadText(const char *filePath);
+    bool load(const char *filePath);
+    bool save(const char *filePath) const;
+};
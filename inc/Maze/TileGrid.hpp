@@ -0,0 +1,83 @@
+// Compact grid recording which tiles of the map are walls. The grid is split
+// into square chunks, and chunks without any walls take up no memory
+
+#pragma once
+
+#include "Util/Arena.hpp"
+#include <cstdint>
+#include <vector>
+
+class TileGrid {
+  public:
+    // Number of tiles along each side of a chunk is 1 << CHUNK_SHIFT
+    static const int CHUNK_SHIFT = 5;
+    static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+
+    // Number of 64-bit words holding the wall bits of one chunk
+    static const int CHUNK_WORDS = CHUNK_SIZE * CHUNK_SIZE / 64;
+
+  private:
+    // Number of tiles along each axis
+    int width;
+    int height;
+
+    // Number of chunks along each axis
+    int chunksX;
+    int chunksY;
+
+    // Position of each chunk's bits within chunkWalls, or -1 if the chunk has
+    // no walls and was never allocated. Chunks are stored row by row
+    ArenaVector<int> chunkSlots;
+
+    // One bit per tile of every allocated chunk, set when the tile is a wall.
+    // Tiles within a chunk are stored row by row
+    ArenaVector<uint64_t> chunkWalls;
+
+    // Index of every tile changed through changeWall, in the order the
+    // changes happened. Navigation data built over the grid reads the entries
+    // added since it was last updated to repair only what changed
+    ArenaVector<int> changes;
+
+  public:
+    TileGrid();
+    TileGrid(int width, int height, Arena *arena = nullptr);
+    TileGrid(const TileGrid &other, Arena *arena);
+
+    int getWidth() const { return this->width; }
+    int getHeight() const { return this->height; }
+
+    // Index of the tile at (x, y) in row-major order
+    int toIndex(int x, int y) const { return y * this->width + x; }
+
+    bool isInBounds(int x, int y) const {
+        return x >= 0 && x < this->width && y >= 0 && y < this->height;
+    }
+
+    // Tiles outside of the grid count as walls so that nothing can leave it
+    bool isWall(int x, int y) const {
+        if (!this->isInBounds(x, y))
+            return true;
+
+        int slot = this->chunkSlots[(y >> CHUNK_SHIFT) * this->chunksX +
+                                    (x >> CHUNK_SHIFT)];
+        if (slot < 0)
+            return false;
+
+        int bit = (y & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (x & (CHUNK_SIZE - 1));
+        return (this->chunkWalls[slot * CHUNK_WORDS + (bit >> 6)] >>
+                (bit & 63)) &
+               1;
+    }
+
+    void setWall(int x, int y, bool isWall);
+    void changeWall(int x, int y, bool isWall);
+    int getChangeCount() const { return this->changes.size(); }
+    int getChange(int i) const { return this->changes[i]; }
+    int getAllocatedChunkCount() const;
+    int getChunkTableSize() const { return this->chunkSlots.size(); }
+    const int *getChunkSlots() const { return this->chunkSlots.data(); }
+    const uint64_t *getChunkWalls() const { return this->chunkWalls.data(); }
+    bool assignChunks(const int32_t *slots, const uint64_t *walls,
+                      int chunkCount);
+    int findOpenNeighbor(int x, int y) const;
+};
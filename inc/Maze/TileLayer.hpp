@@ -0,0 +1,69 @@
+// Walls and floor of a level, pre-rendered into cached textures. The map is
+// split into square blocks of tiles, each rendered once into a texture of its
+// own when it first comes into view and then drawn with a single copy. Only
+// the tiles that change are drawn again
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/TextureAtlas.hpp"
+#include "Util/Window.hpp"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+class TileLayer {
+  public:
+    // Number of tiles along each side of a block
+    static const int BLOCK_SIZE = 32;
+
+    // Most blocks kept rendered at once. The least recently drawn block is
+    // freed to make room for another
+    static const int MAX_BLOCKS = 16;
+
+  private:
+    // Grid the layer draws
+    TileGrid *map;
+
+    // Window the layer is drawn to
+    Window *window;
+
+    // Sprites drawn for walls and open tiles
+    TextureRegion wallSprite;
+    TextureRegion floorSprite;
+
+    // Number of blocks along each axis
+    int blocksX;
+    int blocksY;
+
+    // Rendered texture of each block, or nullptr if it is not rendered
+    std::vector<SDL_Texture *> textures;
+
+    // Frame each block was last drawn in
+    std::vector<uint32_t> lastUsed;
+
+    // Number of blocks that are rendered
+    int textureCount;
+
+    // Number of frames drawn so far
+    uint32_t frame;
+
+    // Number of the grid's wall changes already drawn into the blocks
+    int changeCursor;
+
+    // Cleared if the renderer fails to create a texture to render a block to
+    bool canCache;
+
+    void drawTiles(int startX, int startY, int endX, int endY, int offsetX,
+                   int offsetY);
+    SDL_Texture *renderBlock(int block);
+    void freeOldestBlock();
+    void applyChanges();
+
+  public:
+    TileLayer(TileGrid *map, Window *window);
+    TileLayer(const TileLayer &) = delete;
+    TileLayer &operator=(const TileLayer &) = delete;
+    void render();
+    ~TileLayer();
+};
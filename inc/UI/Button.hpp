@@ -2,27 +2,29 @@
 
 #pragma once
 
+#include "UI/RenderedText.hpp"
 #include "UI/Sprite.hpp"
-#include <SDL2/SDL_ttf.h>
 #include <functional>
 #include <string>
 
 class Button : public Sprite {
   private:
-    // Text displayed on the button
-    std::string text;
-
-    // Font used for rendering the text
-    TTF_Font *font;
+    // Text displayed on the button, rasterized into a texture
+    RenderedText text;
 
     // Function to be called when the button is clicked
     std::function<void()> onClick;
 
+    // Function to be called every frame the mouse is over the button, if any
+    std::function<void()> onHover;
+
     void render() override;
 
   public:
     Button(std::string text, int fontSize, float posX, float posY, float width,
            float height, std::function<void()> onClick, Window *window);
+    void setText(const std::string &text);
+    void setOnHover(std::function<void()> onHover);
     void update() override;
 };
 
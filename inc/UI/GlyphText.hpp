@@ -0,0 +1,30 @@
+// Text laid out glyph by glyph from a glyph atlas and drawn through the sprite
+// batch. Suited to strings that change every frame, such as the HUD, since
+// changing the text never rasterizes anything
+
+#pragma once
+
+#include "UI/Sprite.hpp"
+#include "Util/GlyphAtlas.hpp"
+#include <string>
+
+class GlyphText : public Sprite {
+  private:
+    // Text content to be drawn
+    std::string text;
+
+    // Point size of the font the text is drawn in
+    int fontSize;
+
+    // Glyphs of the font at fontSize, looked up the first time it is drawn
+    GlyphAtlas *atlas;
+
+    GlyphAtlas *getAtlas();
+    void render() override;
+
+  public:
+    GlyphText(int fontSize, float posX, float posY, Window *window);
+    void setText(const char *text);
+    int getTextWidth();
+    void update() override;
+};
@@ -0,0 +1,41 @@
+// A string rasterized into a texture. The texture is kept between frames and
+// only rebuilt when the string, font size or color changes
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+
+class RenderedText {
+  private:
+    // String to rasterize
+    std::string text;
+
+    // Point size of the font the string is drawn in
+    int fontSize;
+
+    // Color the string is drawn in
+    SDL_Color color;
+
+    // The rasterized string, or NULL if it has not been built
+    SDL_Texture *texture;
+
+    // Dimensions of the texture in pixels
+    int width;
+    int height;
+
+    // Set when the texture no longer matches the string, size or color
+    bool isDirty;
+
+    void build(SDL_Renderer *renderer);
+
+  public:
+    RenderedText(const std::string &text, int fontSize, SDL_Color color);
+    RenderedText(const RenderedText &other);
+    RenderedText &operator=(const RenderedText &other);
+    void setText(const std::string &text);
+    void setFontSize(int fontSize);
+    void setColor(SDL_Color color);
+    SDL_Texture *getTexture(SDL_Renderer *renderer, int *width, int *height);
+    ~RenderedText();
+};
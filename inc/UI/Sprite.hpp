@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Util/TextureAtlas.hpp"
 #include "Util/Vector2f.hpp"
 #include "Util/Window.hpp"
 #include <SDL2/SDL_rect.h>
@@ -25,7 +26,16 @@ class Sprite {
     // file
     SDL_Rect currentFrame;
 
-    virtual void render();
+    // Position of the sprite's frames within its texture. Non-zero when the
+    // texture is shared with other sprites, such as the sprite atlas
+    SDL_Point frameOffset;
+
+    // Layer the sprite is drawn on. Sprites on higher layers are drawn over
+    // sprites on lower ones
+    int layer;
+
+    void setTextureRegion(TextureRegion region);
+    void setSprite(const char *filePath);
 
   public:
     Sprite(float posX, float posY, float width, float height,
@@ -34,6 +44,8 @@ class Sprite {
     Vector2f *getPosition();
     Vector2f *getDimensions();
     SDL_Rect *getCurrentFrame();
+    virtual Vector2f getRenderPosition();
+    virtual void render();
     bool isCollidingWith(Sprite *);
     bool isCollidingWith(float x, float y, float width, float height);
     virtual void update();
@@ -2,22 +2,22 @@
 
 #pragma once
 
+#include "UI/RenderedText.hpp"
 #include "UI/Sprite.hpp"
-#include <SDL2/SDL_ttf.h>
 #include <string>
 
 class Text : public Sprite {
   private:
-    // Text content to be rendered
-    std::string text;
-
-    // Font used for rendering the text
-    TTF_Font *font;
+    // Text content rasterized into a texture
+    RenderedText text;
 
     void render() override;
 
   public:
     Text(std::string text, int fontSize, float posX, float posY,
          Window *window);
+    void setText(const std::string &text);
+    void setFontSize(int fontSize);
+    void setColor(SDL_Color color);
     void update() override;
 };
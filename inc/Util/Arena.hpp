@@ -0,0 +1,103 @@
+// Monotonic memory arena for objects that all live exactly as long as one
+// another, such as everything belonging to a level. Allocating bumps a pointer,
+// nothing is freed individually, and the whole arena is emptied at once.
+// Several threads may allocate from an arena at once, as followers planning in
+// parallel do when their search arrays grow
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+class Arena {
+  private:
+    // A contiguous piece of memory handed out from front to back
+    struct Block {
+        char *memory;
+        size_t size;
+    };
+
+    // Blocks allocated so far. Only the last one still has room
+    std::vector<Block> blocks;
+
+    // Number of bytes of the last block handed out
+    size_t used;
+
+    // Number of bytes handed out from every block before the last
+    size_t previousBlocksUsed;
+
+    // Held while allocating, so that threads do not hand out the same memory
+    std::mutex mutex;
+
+    void addBlock(size_t minimumSize);
+
+  public:
+    // Size of the first block, and the smallest size of any block after it
+    static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+    Arena();
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t size, size_t alignment);
+    void reset();
+    size_t getUsed() const;
+    size_t getCapacity() const;
+
+    // Constructs an object inside the arena. Its destructor is never run by
+    // the arena, so objects that own other resources must be destroyed
+    // explicitly before the arena is reset
+    template <typename T, typename... Args> T *create(Args &&...args) {
+        return new (this->allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+    }
+};
+
+// Allocator letting standard containers take their memory from an Arena.
+// Without an arena it falls back to the general-purpose heap, so the same
+// container types work both inside and outside of a level. Containers do not
+// move their arena along when assigned, which keeps every element of a level
+// inside that level's arena
+template <typename T> class ArenaAllocator {
+  public:
+    using value_type = T;
+
+    // The arena memory comes from, or nullptr to use the heap
+    Arena *arena;
+
+    ArenaAllocator(Arena *arena = nullptr) : arena(arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t count) {
+        if (this->arena == nullptr)
+            return static_cast<T *>(::operator new(count * sizeof(T)));
+
+        return static_cast<T *>(
+            this->arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Arena memory is only given back when the whole arena is reset
+    void deallocate(T *pointer, size_t) {
+        if (this->arena == nullptr)
+            ::operator delete(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return this->arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return this->arena != other.arena;
+    }
+};
+
+// Vector whose elements live in an arena, or on the heap without one
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -1,18 +1,49 @@
-// Dimensions of the map in terms of tiles
-#define MAP_SIZE 25
+// Dimensions of the window in terms of tiles. Levels can be any size, and
+// ones larger than the window scroll to keep the player in view
+#define VIEW_SIZE 25
 
 // Dimensions of the tiles in terms of pixels
 #define TILE_SIZE 16
 
-// Calculate the total pixel size of the map based on the number of tiles and
-// tile size
-#define MAP_PIXEL_SIZE (float(MAP_SIZE) * float(TILE_SIZE))
+// Calculate the total pixel size of the window based on the number of tiles
+// and tile size
+#define VIEW_PIXEL_SIZE (float(VIEW_SIZE) * float(TILE_SIZE))
 
-// Define the base velocity for the player's movement
+// Font used for all text in the game
+#define FONT_PATH "res/fonts/PressStart2P-Regular.ttf"
+
+// File profiling builds write their Chrome trace to
+#define PROFILE_TRACE_PATH "trace.json"
+
+// Number of simulation ticks per second. The simulation advances in steps of
+// this fixed length no matter how fast frames are drawn
+#define TICKS_PER_SECOND 60
+
+// Most ticks simulated in a single frame. Time beyond that is dropped, so a
+// long frame cannot make the next one longer still
+#define MAX_TICKS_PER_FRAME 5
+
+// Define the base velocity for the player's movement, in pixels per tick
 #define PLAYER_BASE_VELOCITY 2
 
-// Define the base velocity for the follower's movement
+// Define the base velocity for the follower's movement, in pixels per tick
 #define FOLLOWER_BASE_VELOCITY 1
 
+// Maps at least this many tiles across plan follower paths hierarchically
+#define HIERARCHICAL_MIN_MAP_SIZE 64
+
+// Number of tiles along each side of a hierarchical pathfinding cluster
+#define HIERARCHICAL_CLUSTER_SIZE 16
+
+// Fewest followers in a level for them to plan on the thread pool. Fewer plan
+// on the game thread, since waking the workers would cost more than it saves
+#define PARALLEL_MIN_FOLLOWERS 8
+
+// Layers sprites are drawn on. Sprites on higher layers are drawn over lower
+// ones
+#define KEY_LAYER 0
+#define ENTITY_LAYER 1
+#define HUD_LAYER 2
+
 // Define the total number of levels in the game
 #define NUM_LEVELS 3
@@ -0,0 +1,30 @@
+// Distance map from every open tile to a single goal tile. Any number of
+// entities heading for the same goal can read their next step from it
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include <vector>
+
+class FlowField {
+  private:
+    // Grid the field was built over
+    TileGrid *map;
+
+    // Tile every distance is measured to, or -1 if the field is empty
+    int goal;
+
+    // Number of moves from each tile to the goal, or -1 if unreachable
+    ArenaVector<int> distances;
+
+    // Frontier of the breadth-first search, kept to avoid reallocating it
+    ArenaVector<int> frontier;
+
+  public:
+    FlowField(Arena *arena = nullptr);
+    void rebuild(TileGrid *map, int goal);
+    int getGoal();
+    int getDistance(int tile);
+    int getNextStep(int tile);
+};
@@ -0,0 +1,20 @@
+// Process-wide cache of opened fonts, so that every piece of text drawn with
+// the same font file and size shares one TTF_Font
+
+#pragma once
+
+#include <SDL2/SDL_ttf.h>
+#include <map>
+#include <string>
+#include <utility>
+
+class FontCache {
+  private:
+    // Opened fonts keyed by file path and point size. Fonts that failed to
+    // open are kept as NULL so they are not retried every frame
+    static std::map<std::pair<std::string, int>, TTF_Font *> fonts;
+
+  public:
+    static TTF_Font *getFont(const std::string &filePath, int size);
+    static void clear();
+};
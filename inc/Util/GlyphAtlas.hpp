@@ -0,0 +1,38 @@
+// Every printable ASCII character of a font rasterized once into a single
+// texture, so that text can be laid out as quads without touching SDL_ttf
+
+#pragma once
+
+#include <SDL2/SDL.h>
+
+class GlyphAtlas {
+  public:
+    // First and last characters packed into the atlas
+    static const char FIRST_GLYPH = ' ';
+    static const char LAST_GLYPH = '~';
+
+    // Where a character is within the texture and how far it moves the pen
+    struct Glyph {
+        SDL_Rect rect;
+        int advance;
+    };
+
+  private:
+    // The packed texture, or NULL if the atlas has not been built
+    SDL_Texture *texture;
+
+    // Every packed character, starting from FIRST_GLYPH
+    Glyph glyphs[LAST_GLYPH - FIRST_GLYPH + 1];
+
+    // Distance between the tops of two lines of text
+    int lineHeight;
+
+  public:
+    GlyphAtlas();
+    bool build(SDL_Renderer *renderer, const char *fontPath, int fontSize);
+    bool isBuilt();
+    SDL_Texture *getTexture();
+    const Glyph *getGlyph(char c);
+    int getLineHeight();
+    void destroy();
+};
@@ -0,0 +1,151 @@
+// Hierarchical pathfinding (HPA*) for large maps. The map is split into square
+// clusters connected through entrances on their borders. Paths are planned
+// over the small graph of entrances and only refined tile by tile inside the
+// cluster the searcher is in
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/SearchState.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Graph of cluster entrances built over a TileGrid. It is shared by every
+// searcher and only changes when walls do
+class HierarchicalMap {
+  public:
+    // Path from an entrance to another entrance
+    struct Edge {
+        // Entrance tile the path leads to, and its node id
+        int tile;
+        int node;
+
+        int cost;
+    };
+
+    // Entrance tile of a cluster
+    struct Node {
+        // Index of the tile in the map
+        int tile;
+
+        // Number of the entrance across the whole map, see getNodeId
+        int id;
+
+        // Entrances in adjacent clusters one step away
+        std::vector<Edge> partners;
+
+        // Other entrances of the same cluster reachable without leaving it
+        std::vector<Edge> edges;
+    };
+
+  private:
+    // Grid the graph was built over
+    TileGrid *map;
+
+    // Number of tiles along each side of a cluster
+    int clusterSize;
+
+    // Number of clusters along each axis
+    int clustersX;
+    int clustersY;
+
+    // Number of the grid's wall changes already applied to the graph
+    int changeCursor;
+
+    // Entrances of each cluster
+    std::vector<std::vector<Node>> clusters;
+
+    // Pairs of facing entrance tiles on the border between each cluster and
+    // the cluster to its right, and the cluster below it
+    std::vector<std::vector<std::pair<int, int>>> verticalBorders;
+    std::vector<std::vector<std::pair<int, int>>> horizontalBorders;
+
+    // Position of each entrance tile within its cluster's entrances, or -1
+    std::vector<int> nodeIndices;
+
+    // Number of entrances in the clusters before each cluster, and in total at
+    // the end, so that entrances are numbered from 0 across the whole map
+    std::vector<int> clusterOffsets;
+
+    // Entrance with each node id
+    std::vector<Node *> nodesById;
+
+    // Scratch space for the breadth-first searches between entrances
+    std::vector<uint8_t> openTiles;
+    std::vector<int> distances;
+    std::vector<int> frontier;
+
+    void findTransitions(int ax, int ay, int bx, int by, int length, int stepX,
+                         int stepY, std::vector<std::pair<int, int>> *border);
+    void buildBorders(int clusterX, int clusterY);
+    void addNode(int cluster, int tile, int partner);
+    void buildNodes(int clusterX, int clusterY);
+    void buildEdges(int cluster);
+    void rebuildCluster(int clusterX, int clusterY);
+    void numberNodes();
+
+  public:
+    HierarchicalMap();
+    void build(TileGrid *map, int clusterSize);
+    void update();
+    TileGrid *getMap();
+    void setMap(TileGrid *map);
+    int getClusterOf(int tile);
+    void getClusterBounds(int cluster, int *x, int *y, int *width,
+                          int *height);
+    std::vector<Node> *getNodes(int cluster);
+    Node *getNode(int tile);
+    int getNodeCount();
+    int getNodeId(int tile);
+    Node *getNodeById(int id);
+};
+
+// Reusable query state for searching a HierarchicalMap. Each searcher owns one
+// so that several can search the same map at once
+class HierarchicalPathSearch {
+  private:
+    // Breadth-first search confined to a single cluster. Its arrays cover the
+    // cluster plus a one tile border, row by row
+    struct LocalSearch {
+        int x;
+        int y;
+        int stride;
+        int height;
+        ArenaVector<uint8_t> openTiles;
+        ArenaVector<int> distances;
+        ArenaVector<int> parents;
+        ArenaVector<int> frontier;
+
+        LocalSearch(Arena *arena);
+    };
+
+    // Searches from the start and from the goal through their clusters
+    LocalSearch startSearch;
+    LocalSearch goalSearch;
+
+    // Cost of the cheapest known path from the start to each entrance, and the
+    // entrance each was reached from, or -1 if reached from the start. Both
+    // are by node id
+    SearchScores<PathScore> scores;
+
+    // Entrances waiting to be expanded
+    OpenList<OpenNode> open;
+
+    // Number of tiles and entrances expanded by the most recent search
+    int expandedCount;
+
+    void reset(HierarchicalMap *graph);
+    void searchCluster(HierarchicalMap *graph, int cluster, int from,
+                       LocalSearch *search);
+    int toLocal(LocalSearch *search, TileGrid *map, int tile);
+    int getLocalDistance(LocalSearch *search, TileGrid *map, int tile);
+    int findLocalStep(LocalSearch *search, TileGrid *map, int start,
+                      int target);
+
+  public:
+    HierarchicalPathSearch(Arena *arena = nullptr);
+    int findNextStep(int start, int goal, HierarchicalMap *graph);
+    int getExpandedCount();
+};
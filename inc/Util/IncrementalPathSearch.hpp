@@ -0,0 +1,92 @@
+// Incremental A* (Lifelong Planning A*) that repairs its previous search
+// instead of starting over when the goal moves or walls change
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/SearchState.hpp"
+#include <vector>
+
+class IncrementalPathSearch {
+  private:
+    // What the search knows about a tile
+    struct TileScore {
+        // Distance from the start as of the last time the tile was expanded
+        int gScore;
+
+        // One-step lookahead distance from the start, computed from the
+        // gScore of the tile's neighbours. A tile is consistent when both
+        // agree
+        int rhsScore;
+
+        // Priority the tile was last queued with
+        int primaryKey;
+        int secondaryKey;
+
+        // Whether the tile is waiting to be expanded
+        bool isQueued;
+    };
+
+    // Entry in the open list. Entries are ordered by the first key, then by
+    // the second, then by tile. A tile's entries are left in the list when it
+    // is taken out of the queue or queued again, and skipped once they no
+    // longer match its score
+    struct QueueEntry {
+        int primaryKey;
+        int secondaryKey;
+        int tile;
+
+        static bool isBefore(const QueueEntry &a, const QueueEntry &b);
+    };
+
+    // Grid the search was built over
+    TileGrid *map;
+
+    // Tile the search is rooted at. Distances are measured from here, so the
+    // search has to start over when it changes. Rooting at the follower rather
+    // than at the player, as D* Lite would, restarts less often: the player is
+    // twice as fast and so changes tiles twice as often
+    int start;
+
+    // Tile the search is currently heading for
+    int goal;
+
+    // Next step found by the most recent search
+    int nextStep;
+
+    // Number of the grid's wall changes already applied to the search
+    int changeCursor;
+
+    // Whether the goal or the walls changed since the last search
+    bool isDirty;
+
+    // Score of every tile, reset every time the search starts over
+    SearchScores<TileScore> scores;
+
+    // Inconsistent tiles waiting to be expanded
+    OpenList<QueueEntry> open;
+
+    // Number of tiles expanded by the most recent search
+    int expandedCount;
+
+    void reset(TileGrid *map, int start);
+    void touch(int tile);
+    int heuristic(int tile);
+    QueueEntry calculateKey(int tile);
+    bool isStale(const QueueEntry &entry);
+    void pushHeap(int tile);
+    void removeFromHeap(int tile);
+    int peekHeap();
+    void rekeyHeap();
+    void updateVertex(int tile);
+    void updateNeighbors(int tile);
+    void applyWallChanges();
+    void computeShortestPath();
+    int extractNextStep();
+
+  public:
+    IncrementalPathSearch(Arena *arena = nullptr);
+    int findNextStep(int start, int goal, TileGrid *map);
+    int getExpandedCount();
+};
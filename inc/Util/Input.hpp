@@ -0,0 +1,56 @@
+// Player input for a single simulation tick, and the sources it can come
+// from. The simulation only ever sees InputStates, so it can be driven by the
+// keyboard, a bot or a recording alike
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+// Buttons the player can hold, as bits of InputState::buttons
+enum InputButton : uint8_t {
+    INPUT_FORWARD = 1 << 0,
+    INPUT_BACK = 1 << 1,
+    INPUT_LEFT = 1 << 2,
+    INPUT_RIGHT = 1 << 3,
+    INPUT_ROTATE_LEFT = 1 << 4,
+    INPUT_ROTATE_RIGHT = 1 << 5,
+};
+
+// Buttons held during a tick
+struct InputState {
+    uint8_t buttons;
+
+    bool isHeld(InputButton button) const { return this->buttons & button; }
+};
+
+// Produces the input for each tick
+class InputSource {
+  public:
+    virtual InputState poll() = 0;
+    virtual ~InputSource() {}
+};
+
+// Input read from the keyboard: WASD to move, the arrow keys to turn
+class KeyboardInput : public InputSource {
+  public:
+    InputState poll() override;
+};
+
+// Input from a bot that holds random buttons for random stretches of time.
+// The same seed always produces the same input
+class RandomInput : public InputSource {
+  private:
+    // Generator the buttons and durations are drawn from
+    std::mt19937 random;
+
+    // Buttons currently held
+    InputState current;
+
+    // Ticks left before picking new buttons
+    int ticksLeft;
+
+  public:
+    RandomInput(unsigned int seed);
+    InputState poll() override;
+};
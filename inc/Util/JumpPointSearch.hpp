@@ -0,0 +1,39 @@
+// Jump Point Search for 4-connected, uniform-cost grids. Straight runs of
+// open tiles are skipped over instead of being expanded one tile at a time
+
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/SearchState.hpp"
+#include <vector>
+
+class JumpPointSearch {
+  private:
+    // Grid and goal of the search in progress
+    TileGrid *map;
+    int goal;
+
+    // Cost of the cheapest known path from the start to each jump point, and
+    // the jump point each was reached from on that path
+    SearchScores<PathScore> scores;
+
+    // Jump points waiting to be expanded
+    OpenList<OpenNode> open;
+
+    // Number of jump points expanded by the most recent search
+    int expandedCount;
+
+    int heuristic(int tile);
+    void reset(TileGrid *map, int goal);
+    bool isOpen(int x, int y);
+    int jumpHorizontal(int x, int y, int dx);
+    int jumpVertical(int x, int y, int dy);
+    void addSuccessor(const OpenNode &current, int successor);
+    bool search(int start, int goal, TileGrid *map);
+
+  public:
+    JumpPointSearch(Arena *arena = nullptr);
+    int findNextStep(int start, int goal, TileGrid *map);
+    int getExpandedCount();
+};
@@ -1,11 +1,54 @@
 // Pathfinding implementation with A*
 
-#include "Maze/Tile.hpp"
-#include "Util/Vector2f.hpp"
-#include <map>
+#pragma once
+
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/SearchState.hpp"
 #include <vector>
 
-int heuristic(Tile *current, Tile *goal);
+// Strategies a Follower can use to find its way to the player
+enum class PathfindingMode {
+    // Run an A* search from the follower every frame
+    AStar,
+
+    // Run a Jump Point Search from the follower every frame
+    JumpPoint,
+
+    // Keep an incremental search that is only repaired when the player, the
+    // follower or the walls move
+    Incremental,
+
+    // Read the next step from a flow field shared by every follower
+    FlowField,
+
+    // Plan over the cluster entrances of a HierarchicalMap shared by every
+    // follower, for maps too large to search tile by tile
+    Hierarchical,
+};
+
+// Reusable A* search over a TileGrid. All per-tile bookkeeping lives in flat
+// arrays indexed by tile that are kept between searches and invalidated with a
+// generation counter, so once warmed up a search performs no allocations.
+class PathSearch {
+  private:
+    // Cost of the cheapest known path from the start to each tile, and the
+    // tile each tile was reached from on that path
+    SearchScores<PathScore> scores;
+
+    // Tiles waiting to be expanded
+    OpenList<OpenNode> open;
+
+    // Number of tiles expanded by the most recent search
+    int expandedCount;
+
+    int heuristic(int current, int goal, TileGrid *map);
+    void reset(TileGrid *map);
+    bool search(int start, int goal, TileGrid *map);
 
-std::unordered_map<Tile *, Tile *>
-findPath(Tile *start, Tile *goal, std::vector<std::vector<Tile>> *map);
+  public:
+    PathSearch(Arena *arena = nullptr);
+    int findNextStep(int start, int goal, TileGrid *map);
+    bool findPath(int start, int goal, TileGrid *map, std::vector<int> *path);
+    int getExpandedCount();
+};
@@ -0,0 +1,77 @@
+// Frame profiler timing named scopes of the game, such as a frame's update and
+// render. Each thread records the scopes it finishes into its own ring buffer,
+// which the on-screen overlay summarizes and which can be written out as a
+// Chrome trace_event file. Unless the game is built with PROFILING defined, as
+// `make profile` does, the markers compile to nothing
+
+#pragma once
+
+// Times the rest of the enclosing scope under a name, which must be a string
+// literal
+#ifdef PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name)                                                    \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD_NAME(name)
+#endif
+
+#ifdef PROFILING
+
+#include <cstdint>
+#include <vector>
+
+// A scope that has finished running
+struct ProfileEvent {
+    // Name the scope was marked with
+    const char *name;
+
+    // When the scope was entered, and how long it ran for, in nanoseconds
+    int64_t start;
+    int64_t duration;
+};
+
+// How long the scopes with one name took over a period
+struct ProfileStats {
+    const char *name;
+
+    // Number of times a scope with the name finished
+    int count;
+
+    // Total and longest time spent in one of them, in nanoseconds
+    int64_t total;
+    int64_t max;
+};
+
+class Profiler {
+  public:
+    // Number of events each thread keeps before overwriting its oldest
+    static const int BUFFER_SIZE = 1 << 16;
+
+    static int64_t now();
+    static void record(const char *name, int64_t start, int64_t end);
+    static void setThreadName(const char *name);
+    static void getStats(int64_t since, std::vector<ProfileStats> *stats);
+    static bool writeTrace(const char *filePath);
+};
+
+// Records the time between its construction and destruction
+class ProfileScope {
+  private:
+    const char *name;
+    int64_t start;
+
+  public:
+    ProfileScope(const char *name) : name(name), start(Profiler::now()) {}
+    ~ProfileScope() {
+        Profiler::record(this->name, this->start, Profiler::now());
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#endif
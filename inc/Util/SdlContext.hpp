@@ -0,0 +1,14 @@
+// Initializes SDL, SDL Image and SDL TTF for as long as it exists, and shuts
+// SDL down when it is destroyed. Anything holding SDL resources must be
+// destroyed first, so it belongs after the context in its owner
+
+#pragma once
+
+class SdlContext {
+  public:
+    SdlContext();
+    ~SdlContext();
+
+    SdlContext(const SdlContext &) = delete;
+    SdlContext &operator=(const SdlContext &) = delete;
+};
@@ -0,0 +1,173 @@
+// Bookkeeping shared by the searches: per-node scores kept between searches
+// and invalidated with a generation counter, and the binary heap they expand
+// nodes from. Once warmed up, neither allocates
+
+#pragma once
+
+#include "Util/Arena.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Cost of the cheapest known path from the start to a node, and the node it
+// was reached from on that path
+struct PathScore {
+    int gScore;
+    int parent;
+};
+
+// Entry in the open list of an A* search. Entries are ordered by fScore, then
+// by heuristic, then by node
+struct OpenNode {
+    int fScore;
+    int hScore;
+    int gScore;
+    int node;
+
+    // Breaks ties with the heuristic and then the node so that searches are
+    // deterministic
+    static bool isBefore(const OpenNode &a, const OpenNode &b) {
+        if (a.fScore != b.fScore)
+            return a.fScore < b.fScore;
+        if (a.hScore != b.hScore)
+            return a.hScore < b.hScore;
+        return a.node < b.node;
+    }
+};
+
+// Scores of every node of a search, indexed by node. Instead of clearing every
+// node between searches, a generation counter is advanced so that scores
+// written by earlier searches become stale
+template <typename Score> class SearchScores {
+  private:
+    // Score of each node, only meaningful if the node was visited
+    ArenaVector<Score> scores;
+
+    // Generation in which each node's score was last written
+    ArenaVector<uint32_t> stamps;
+
+    // Current search generation
+    uint32_t generation;
+
+  public:
+    SearchScores(Arena *arena = nullptr)
+        : scores(ArenaAllocator<Score>(arena)),
+          stamps(ArenaAllocator<uint32_t>(arena)), generation(0) {}
+
+    // Starts a new search over a number of nodes, leaving every node
+    // unvisited. The arrays only grow when there are more nodes than before
+    void reset(size_t numNodes) {
+        if (this->stamps.size() < numNodes) {
+            this->scores.resize(numNodes);
+            this->stamps.assign(numNodes, 0);
+            this->generation = 0;
+        }
+
+        this->generation++;
+
+        // Every stamp is ambiguous once the counter wraps around, so clear
+        // them
+        if (this->generation == 0) {
+            std::fill(this->stamps.begin(), this->stamps.end(), 0);
+            this->generation = 1;
+        }
+    }
+
+    // Whether a node's score was written during the current search
+    bool isVisited(int node) const {
+        return this->stamps[node] == this->generation;
+    }
+
+    // Marks a node visited and returns its score to be written
+    Score &visit(int node) {
+        this->stamps[node] = this->generation;
+        return this->scores[node];
+    }
+
+    // Score of a node visited during the current search
+    Score &operator[](int node) { return this->scores[node]; }
+};
+
+// Binary min-heap of entries waiting to be expanded, ordered by
+// Entry::isBefore
+template <typename Entry> class OpenList {
+  private:
+    ArenaVector<Entry> heap;
+
+    // Moves an entry down from a position until both of its children come
+    // after it
+    void siftDown(size_t i, Entry entry) {
+        size_t size = this->heap.size();
+
+        while (true) {
+            size_t child = 2 * i + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size &&
+                Entry::isBefore(this->heap[child + 1], this->heap[child]))
+                child++;
+            if (!Entry::isBefore(this->heap[child], entry))
+                break;
+            this->heap[i] = this->heap[child];
+            i = child;
+        }
+
+        this->heap[i] = entry;
+    }
+
+  public:
+    OpenList(Arena *arena = nullptr) : heap(ArenaAllocator<Entry>(arena)) {}
+
+    bool isEmpty() const { return this->heap.empty(); }
+
+    void clear() { this->heap.clear(); }
+
+    // First entry, which must exist
+    const Entry &top() const { return this->heap[0]; }
+
+    void push(const Entry &entry) {
+        size_t i = this->heap.size();
+        this->heap.push_back(entry);
+
+        // Sift the entry up until its parent comes before it
+        while (i > 0) {
+            size_t up = (i - 1) / 2;
+            if (!Entry::isBefore(entry, this->heap[up]))
+                break;
+            this->heap[i] = this->heap[up];
+            i = up;
+        }
+
+        this->heap[i] = entry;
+    }
+
+    // Removes and returns the first entry, which must exist
+    Entry pop() {
+        Entry top = this->heap[0];
+        Entry last = this->heap.back();
+        this->heap.pop_back();
+
+        if (!this->heap.empty()) {
+            this->siftDown(0, last);
+        }
+
+        return top;
+    }
+
+    // Passes every entry to a function that may change its key, and drops
+    // the entries it returns false for, then restores the heap order
+    template <typename Update> void rebuild(Update update) {
+        size_t kept = 0;
+        for (size_t i = 0; i < this->heap.size(); i++) {
+            Entry entry = this->heap[i];
+            if (update(&entry)) {
+                this->heap[kept++] = entry;
+            }
+        }
+        this->heap.resize(kept);
+
+        for (size_t i = kept / 2; i-- > 0;) {
+            this->siftDown(i, this->heap[i]);
+        }
+    }
+};
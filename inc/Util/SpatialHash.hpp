@@ -0,0 +1,54 @@
+// Uniform grid of cells over a level, bucketing entities by where they are so
+// that finding the entities touching a box only looks at the cells around it.
+// Levels are bounded, so cells are indexed directly rather than hashed
+
+#pragma once
+
+#include "Util/Arena.hpp"
+#include "Util/Constants.hpp"
+
+class SpatialHash {
+  public:
+    // Size of the cells in pixels. Entities may be no larger than a cell
+    static const int CELL_SIZE = 2 * TILE_SIZE;
+
+  private:
+    // An entity's bounding box and its place in the list of its cell
+    struct Item {
+        float x;
+        float y;
+        float width;
+        float height;
+
+        // Cell holding the entity, or -1 if there is no entity with this id
+        int cell;
+
+        // Neighbours in the cell's list, or -1 at either end
+        int next;
+        int previous;
+    };
+
+    // Number of cells across and down
+    int columns;
+    int rows;
+
+    // First entity in each cell, or -1 for an empty cell
+    ArenaVector<int> cells;
+
+    // Every entity, indexed by its id
+    ArenaVector<Item> items;
+
+    int getColumn(float x);
+    int getRow(float y);
+    void link(int id, int cell);
+    void unlink(int id);
+
+  public:
+    SpatialHash(Arena *arena = nullptr);
+    void setBounds(int width, int height);
+    void insert(int id, float x, float y, float width, float height);
+    void move(int id, float x, float y);
+    void remove(int id);
+    void query(float x, float y, float width, float height,
+               ArenaVector<int> *results);
+};
@@ -0,0 +1,45 @@
+// Collects the sprites drawn during a frame and submits them together. Sprites
+// are grouped by layer and texture, and every group is drawn with a single
+// SDL_RenderGeometry call
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+class SpriteBatch {
+  private:
+    // A sprite waiting to be drawn
+    struct Quad {
+        int layer;
+        SDL_Texture *texture;
+        SDL_Rect src;
+        SDL_Rect dst;
+
+        // Position of the quad in the order the sprites were drawn, keeping
+        // overlapping sprites of the same group in that order
+        uint32_t order;
+    };
+
+    // Sprites drawn since the last flush
+    std::vector<Quad> quads;
+
+    // Corners and triangles of the group being submitted, kept to avoid
+    // reallocating them every frame
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    // Number of draw calls made by the most recent flush
+    int drawCallCount;
+
+    static bool isBefore(const Quad &a, const Quad &b);
+    void submitGroup(SDL_Renderer *renderer, int start, int end);
+
+  public:
+    SpriteBatch();
+    void draw(SDL_Texture *texture, const SDL_Rect &src, const SDL_Rect &dst,
+              int layer);
+    void flush(SDL_Renderer *renderer);
+    int getDrawCallCount();
+};
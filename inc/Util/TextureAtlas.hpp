@@ -0,0 +1,31 @@
+// Packs several small images into a single texture so that sprites sharing it
+// can be drawn from one GPU resource using per-sprite source rectangles
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A texture along with the rectangle of it that holds a given image
+struct TextureRegion {
+    SDL_Texture *texture;
+    SDL_Rect rect;
+};
+
+class TextureAtlas {
+  private:
+    // The packed texture, or NULL if the atlas has not been built
+    SDL_Texture *texture;
+
+    // Location of every packed image within the texture, keyed by file path
+    std::unordered_map<std::string, SDL_Rect> regions;
+
+  public:
+    TextureAtlas();
+    bool build(SDL_Renderer *renderer, const std::vector<const char *> &files);
+    bool isBuilt();
+    bool getRegion(const char *filePath, TextureRegion *region);
+    void destroy();
+};
@@ -0,0 +1,57 @@
+// Worker threads kept for the whole run of the game, which the iterations of a
+// loop can be spread across. The threads are started once, so handing them a
+// loop costs waking them up rather than starting new threads
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+  private:
+    // Threads running the loop alongside the thread that started it
+    std::vector<std::thread> workers;
+
+    // Guards everything below except nextIndex
+    std::mutex mutex;
+
+    // Signalled when a loop starts or the pool is stopping, and when the last
+    // worker finishes its share of a loop
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+
+    // Body of the loop being run, and its number of iterations
+    const std::function<void(int)> *task;
+    int taskCount;
+
+    // Next iteration of the loop no thread has claimed yet
+    std::atomic<int> nextIndex;
+
+    // Number of workers still running their share of the loop
+    int activeWorkers;
+
+    // Bumped for every loop, so that workers can tell a new loop has started
+    uint64_t generation;
+
+    // Whether the workers should exit
+    bool isStopping;
+
+    void run();
+    void runTasks();
+
+  public:
+    ThreadPool(int numWorkers);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int getThreadCount() const;
+    void parallelFor(int count, const std::function<void(int)> &task);
+
+    static ThreadPool *getShared();
+};
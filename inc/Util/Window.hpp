@@ -3,21 +3,73 @@
 
 #pragma once
 
+#include "Util/GlyphAtlas.hpp"
+#include "Util/SpriteBatch.hpp"
+#include "Util/TextureAtlas.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <map>
+#include <string>
+#include <unordered_map>
 
 class Window {
   private:
+    // A texture loaded from disk along with the number of users holding it
+    struct CachedTexture {
+        SDL_Texture *texture;
+        int refCount;
+    };
+
     // SDL window pointer
     SDL_Window *sdlWindow;
 
     // SDL renderer pointer
     SDL_Renderer *renderer;
 
+    // Textures loaded through loadTexture, keyed by file path, including the
+    // sprites that are not part of the atlas. Images that failed to load are
+    // kept as NULL
+    std::unordered_map<std::string, CachedTexture> textureCache;
+
+    // Shared texture holding all of the small in-game sprites
+    TextureAtlas atlas;
+
+    // Whether building the atlas has been tried, so a failed build is not
+    // tried again for every sprite
+    bool isAtlasAttempted;
+
+    // Glyphs of the game's font, rasterized at each size text is drawn in
+    std::map<int, GlyphAtlas> glyphAtlases;
+
+    // Sprites drawn during the current frame, submitted when it is displayed
+    SpriteBatch spriteBatch;
+
+    // Dimensions of the window in pixels
+    int width;
+    int height;
+
+    // Top-left corner of the visible part of the level in pixels, subtracted
+    // from the position of every sprite drawn
+    SDL_Point camera;
+
+    // How far the current frame is between the last simulation tick and the
+    // next one, from 0 to 1
+    float interpolation;
+
   public:
     Window(const char *title, int width, int height);
     SDL_Renderer *getRenderer();
+    SpriteBatch *getSpriteBatch();
+    int getWidth();
+    int getHeight();
+    void setCamera(int x, int y);
+    SDL_Point getCamera();
+    void setInterpolation(float interpolation);
+    float getInterpolation();
     SDL_Texture *loadTexture(const char *filePath);
+    void releaseTexture(SDL_Texture *texture);
+    TextureRegion loadSprite(const char *filePath);
+    GlyphAtlas *getGlyphAtlas(int fontSize);
     void clear();
     void display();
     ~Window();
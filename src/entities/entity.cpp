@@ -21,7 +21,8 @@
 Entity::Entity(float posX, float posY, float width, float height, float velX,
                float velY, SDL_Texture *texture, Window *window)
     : Sprite(posX, posY, width, height, texture, window),
-      velocity(Vector2f{.x = velX, .y = velY}) {}
+      velocity(Vector2f{.x = velX, .y = velY}),
+      previousPosition(Vector2f{.x = posX, .y = posY}) {}
 
 /**
  * Move the entity based on its current velocity.
@@ -37,3 +38,25 @@ void Entity::move() {
  * @return Pointer to the Vector2f representing the velocity.
  */
 Vector2f *Entity::getVelocity() { return &this->velocity; }
+
+/**
+ * Remembers the current position as where the entity was at the start of the
+ * tick. Called before the entity moves each tick.
+ */
+void Entity::savePreviousPosition() { this->previousPosition = this->position; }
+
+/**
+ * Get the position to draw the entity at, blending its positions before and
+ * after the latest tick by how far the frame is into the next one.
+ *
+ * @return The interpolated position.
+ */
+Vector2f Entity::getRenderPosition() {
+    float alpha = this->window->getInterpolation();
+
+    return Vector2f{
+        .x = this->previousPosition.x +
+             (this->position.x - this->previousPosition.x) * alpha,
+        .y = this->previousPosition.y +
+             (this->position.y - this->previousPosition.y) * alpha};
+}
@@ -0,0 +1,373 @@
+// Stores many simple entities such as keys and followers as parallel arrays,
+// one per component. Each pass over the entities (moving, colliding with
+// walls, drawing) only walks the arrays it needs, keeping the data it touches
+// contiguous. Entities are referred to by generational handles, which stay
+// valid while entities around them are removed and never mistake a newer
+// entity for one that was removed
+
+#include "Entities/EntityStorage.hpp"
+#include "Maze/TileGrid.hpp"
+#include "Util/Arena.hpp"
+#include "Util/Constants.hpp"
+#include "Util/Profiler.hpp"
+#include "Util/SpriteBatch.hpp"
+#include "Util/TextureAtlas.hpp"
+#include "Util/Window.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Constructor for an EntityStorage holding no entities.
+ *
+ * @param arena Arena to allocate the component arrays from, or nullptr to use
+ * the heap.
+ */
+EntityStorage::EntityStorage(Arena *arena)
+    : slots(ArenaAllocator<int>(arena)), indices(ArenaAllocator<int>(arena)),
+      generations(ArenaAllocator<uint32_t>(arena)), freeSlot(-1),
+      positionX(ArenaAllocator<float>(arena)),
+      positionY(ArenaAllocator<float>(arena)),
+      previousX(ArenaAllocator<float>(arena)),
+      previousY(ArenaAllocator<float>(arena)),
+      velocityX(ArenaAllocator<float>(arena)),
+      velocityY(ArenaAllocator<float>(arena)),
+      width(ArenaAllocator<float>(arena)), height(ArenaAllocator<float>(arena)),
+      textures(ArenaAllocator<SDL_Texture *>(arena)),
+      frames(ArenaAllocator<SDL_Rect>(arena)),
+      layers(ArenaAllocator<int>(arena)) {}
+
+/**
+ * Adds an entity that starts out still.
+ *
+ * @param posX Initial X-coordinate.
+ * @param posY Initial Y-coordinate.
+ * @param width Width of the entity.
+ * @param height Height of the entity.
+ * @param sprite The texture region the entity is drawn from. An area the size
+ * of the entity is drawn from its top-left corner.
+ * @param layer Layer the entity is drawn on.
+ * @return Handle of the new entity.
+ */
+EntityHandle EntityStorage::create(float posX, float posY, float width,
+                                   float height, TextureRegion sprite,
+                                   int layer) {
+    SDL_Rect frame = SDL_Rect{sprite.rect.x, sprite.rect.y, (int)width,
+                              (int)height};
+
+    // Reuse the slot freed most recently, or add one if none are free
+    int slot = this->freeSlot;
+    if (slot != -1) {
+        this->freeSlot = this->indices[slot];
+    } else {
+        slot = this->indices.size();
+        this->indices.push_back(0);
+        this->generations.push_back(0);
+    }
+
+    this->indices[slot] = this->positionX.size();
+    this->slots.push_back(slot);
+
+    this->positionX.push_back(posX);
+    this->positionY.push_back(posY);
+    this->previousX.push_back(posX);
+    this->previousY.push_back(posY);
+    this->velocityX.push_back(0);
+    this->velocityY.push_back(0);
+    this->width.push_back(width);
+    this->height.push_back(height);
+    this->textures.push_back(sprite.texture);
+    this->frames.push_back(frame);
+    this->layers.push_back(layer);
+
+    return EntityHandle{slot, this->generations[slot]};
+}
+
+/**
+ * Removes an entity by moving the last entity into its place, so the
+ * components stay contiguous. The moved entity keeps its handle, though its
+ * index becomes the removed one's. Handles of entities already removed are
+ * ignored.
+ *
+ * @param handle Handle of the entity to remove.
+ */
+void EntityStorage::remove(EntityHandle handle) {
+    if (!this->contains(handle))
+        return;
+
+    int index = this->indices[handle.slot];
+    int last = this->positionX.size() - 1;
+
+    this->slots[index] = this->slots[last];
+    this->indices[this->slots[index]] = index;
+    this->positionX[index] = this->positionX[last];
+    this->positionY[index] = this->positionY[last];
+    this->previousX[index] = this->previousX[last];
+    this->previousY[index] = this->previousY[last];
+    this->velocityX[index] = this->velocityX[last];
+    this->velocityY[index] = this->velocityY[last];
+    this->width[index] = this->width[last];
+    this->height[index] = this->height[last];
+    this->textures[index] = this->textures[last];
+    this->frames[index] = this->frames[last];
+    this->layers[index] = this->layers[last];
+
+    this->slots.pop_back();
+    this->positionX.pop_back();
+    this->positionY.pop_back();
+    this->previousX.pop_back();
+    this->previousY.pop_back();
+    this->velocityX.pop_back();
+    this->velocityY.pop_back();
+    this->width.pop_back();
+    this->height.pop_back();
+    this->textures.pop_back();
+    this->frames.pop_back();
+    this->layers.pop_back();
+
+    // Outdate every handle to the slot before it is reused
+    this->generations[handle.slot]++;
+    this->indices[handle.slot] = this->freeSlot;
+    this->freeSlot = handle.slot;
+}
+
+/**
+ * Removes every entity, keeping the arrays' memory for reuse. Handles of the
+ * removed entities no longer refer to anything.
+ */
+void EntityStorage::clear() {
+    for (int slot : this->slots) {
+        this->generations[slot]++;
+        this->indices[slot] = this->freeSlot;
+        this->freeSlot = slot;
+    }
+
+    this->slots.clear();
+    this->positionX.clear();
+    this->positionY.clear();
+    this->previousX.clear();
+    this->previousY.clear();
+    this->velocityX.clear();
+    this->velocityY.clear();
+    this->width.clear();
+    this->height.clear();
+    this->textures.clear();
+    this->frames.clear();
+    this->layers.clear();
+}
+
+/**
+ * Makes room for a number of entities so that creating them does not
+ * reallocate.
+ *
+ * @param count Number of entities to make room for.
+ */
+void EntityStorage::reserve(int count) {
+    this->slots.reserve(count);
+    this->indices.reserve(count);
+    this->generations.reserve(count);
+    this->positionX.reserve(count);
+    this->positionY.reserve(count);
+    this->previousX.reserve(count);
+    this->previousY.reserve(count);
+    this->velocityX.reserve(count);
+    this->velocityY.reserve(count);
+    this->width.reserve(count);
+    this->height.reserve(count);
+    this->textures.reserve(count);
+    this->frames.reserve(count);
+    this->layers.reserve(count);
+}
+
+/**
+ * Gets the number of entities stored.
+ *
+ * @return The number of entities.
+ */
+int EntityStorage::getSize() { return this->positionX.size(); }
+
+/**
+ * Checks whether a handle still refers to an entity.
+ *
+ * @param handle The handle to check.
+ * @return False if the entity has been removed.
+ */
+bool EntityStorage::contains(EntityHandle handle) {
+    if (handle.slot < 0 || handle.slot >= (int)this->generations.size() ||
+        this->generations[handle.slot] != handle.generation)
+        return false;
+
+    // Free slots hold the next free slot instead of an index of theirs
+    int index = this->indices[handle.slot];
+    return index >= 0 && index < (int)this->slots.size() &&
+           this->slots[index] == handle.slot;
+}
+
+/**
+ * Gets where an entity currently is in the component arrays. Indices change as
+ * other entities are removed, so they are only good until the next removal.
+ *
+ * @param handle Handle of the entity.
+ * @return Index of the entity, or -1 if it has been removed.
+ */
+int EntityStorage::getIndex(EntityHandle handle) {
+    if (!this->contains(handle))
+        return -1;
+
+    return this->indices[handle.slot];
+}
+
+/**
+ * Gets the handle of the entity at an index of the component arrays.
+ *
+ * @param index Index of the entity.
+ * @return Handle of the entity.
+ */
+EntityHandle EntityStorage::getHandle(int index) {
+    int slot = this->slots[index];
+    return EntityHandle{slot, this->generations[slot]};
+}
+
+/**
+ * Gets the handle of the entity in a slot, for code that keeps entities by
+ * their slot alone.
+ *
+ * @param slot Slot of an entity that has not been removed.
+ * @return Handle of the entity.
+ */
+EntityHandle EntityStorage::getHandleInSlot(int slot) {
+    return EntityHandle{slot, this->generations[slot]};
+}
+
+/**
+ * Gets the X-coordinate of an entity.
+ *
+ * @param index Index of the entity.
+ * @return The entity's X-coordinate.
+ */
+float EntityStorage::getX(int index) { return this->positionX[index]; }
+
+/**
+ * Gets the Y-coordinate of an entity.
+ *
+ * @param index Index of the entity.
+ * @return The entity's Y-coordinate.
+ */
+float EntityStorage::getY(int index) { return this->positionY[index]; }
+
+/**
+ * Sets how far an entity moves every tick.
+ *
+ * @param index Index of the entity.
+ * @param velX X velocity.
+ * @param velY Y velocity.
+ */
+void EntityStorage::setVelocity(int index, float velX, float velY) {
+    this->velocityX[index] = velX;
+    this->velocityY[index] = velY;
+}
+
+/**
+ * Remembers every entity's current position as where it was at the start of
+ * the tick. Called before the entities move each tick.
+ */
+void EntityStorage::savePreviousPositions() {
+    this->previousX = this->positionX;
+    this->previousY = this->positionY;
+}
+
+/**
+ * Checks whether a bounding box overlaps any wall tile. Only the tiles covered
+ * by the box are looked at, so the cost does not depend on the size of the
+ * map.
+ *
+ * @param map The grid of walls.
+ * @param x The x-coordinate of the box.
+ * @param y The y-coordinate of the box.
+ * @param width The width of the box.
+ * @param height The height of the box.
+ * @return True if the box is inside a wall, false otherwise.
+ */
+bool isBoxInWall(TileGrid *map, float x, float y, float width, float height) {
+    // Range of tiles the bounding box overlaps. Boxes that only touch a tile's
+    // edge do not collide with it, so the right and bottom edges round up
+    int left = floor(x / TILE_SIZE);
+    int top = floor(y / TILE_SIZE);
+    int right = ceil((x + width) / TILE_SIZE);
+    int bottom = ceil((y + height) / TILE_SIZE);
+
+    for (int row = top; row < bottom; row++) {
+        for (int col = left; col < right; col++) {
+            if (map->isWall(col, row)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Moves every entity by its velocity, one axis at a time. A move along an axis
+ * that would put the entity inside a wall is undone, and its velocity along
+ * that axis is stopped, as WallBoundEntity::move does for a single entity.
+ *
+ * @param map The grid of walls the entities are bound by.
+ */
+void EntityStorage::move(TileGrid *map) {
+    PROFILE_SCOPE("EntityStorage::move");
+
+    int size = this->positionX.size();
+    float *positionX = this->positionX.data();
+    float *positionY = this->positionY.data();
+    float *velocityX = this->velocityX.data();
+    float *velocityY = this->velocityY.data();
+    const float *widths = this->width.data();
+    const float *heights = this->height.data();
+
+    for (int i = 0; i < size; i++) {
+        positionX[i] += velocityX[i];
+
+        if (isBoxInWall(map, positionX[i], positionY[i], widths[i],
+                        heights[i])) {
+            positionX[i] -= velocityX[i];
+            velocityX[i] = 0;
+        }
+
+        positionY[i] += velocityY[i];
+
+        if (isBoxInWall(map, positionX[i], positionY[i], widths[i],
+                        heights[i])) {
+            positionY[i] -= velocityY[i];
+            velocityY[i] = 0;
+        }
+    }
+}
+
+/**
+ * Queues every entity to be drawn through the window's sprite batch, between
+ * its positions before and after the latest tick.
+ *
+ * @param window The window to draw the entities to.
+ */
+void EntityStorage::render(Window *window) {
+    SpriteBatch *batch = window->getSpriteBatch();
+    SDL_Point camera = window->getCamera();
+    float alpha = window->getInterpolation();
+    int size = this->positionX.size();
+
+    for (int i = 0; i < size; i++) {
+        float x = this->previousX[i] +
+                  (this->positionX[i] - this->previousX[i]) * alpha;
+        float y = this->previousY[i] +
+                  (this->positionY[i] - this->previousY[i]) * alpha;
+
+        SDL_Rect dst;
+        dst.x = round(x) - camera.x;
+        dst.y = round(y) - camera.y;
+        dst.w = this->width[i];
+        dst.h = this->height[i];
+
+        batch->draw(this->textures[i], this->frames[i], dst, this->layers[i]);
+    }
+}
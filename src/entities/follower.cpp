@@ -1,117 +1,138 @@
-// Code for Follower movement and actions
+// Code for Follower movement and actions. A follower only decides where to go;
+// its position, velocity and sprite live in an EntityStorage shared with the
+// rest of the horde, which moves and draws them all together
 
 #include "Entities/Follower.hpp"
-#include "Entities/WallBoundEntity.hpp"
+#include "Entities/EntityStorage.hpp"
+#include "Maze/TileGrid.hpp"
 #include "Util/Constants.hpp"
 #include "Util/Pathfinding.hpp"
-#include <iostream>
+#include "Util/Profiler.hpp"
+#include <cmath>
 
 /**
- * Constructor for Follower class with a Window pointer.
+ * Constructor for Follower class with specific parameters.
  *
- * @param window Pointer to the game window.
+ * @param bodies Storage holding the follower's position, velocity and sprite.
+ * @param index Index of the follower's body in the storage.
+ * @param map Pointer to the grid of walls.
+ * @param player Pointer to the player object.
+ * @param arena Arena to allocate the follower's search arrays from, or nullptr
+ * to use the heap.
  */
-Follower::Follower(Window *window)
-    : WallBoundEntity(0, 0, 0, 0, 0, 0, NULL, NULL, window) {
-    // Load follower texture
-    this->texture = window->loadTexture("res/img/Steven.png");
+Follower::Follower(EntityStorage *bodies, int index, TileGrid *map,
+                   Player *player, Arena *arena)
+    : bodies(bodies), index(index), map(map), player(player),
+      pathfindingMode(PathfindingMode::AStar), pathSearch(arena),
+      incrementalSearch(arena), jumpPointSearch(arena),
+      hierarchicalSearch(arena), flowField(nullptr), hierarchicalMap(nullptr) {
 }
 
 /**
- * Constructor for Follower class with specific parameters.
+ * Set how the follower finds its way to the player.
  *
- * @param posX Initial X-coordinate.
- * @param posY Initial Y-coordinate.
- * @param velX Initial X velocity.
- * @param velY Initial Y velocity.
- * @param map Pointer to the game map.
- * @param player Pointer to the player object.
- * @param window Pointer to the game window.
+ * @param mode The pathfinding strategy to use.
+ * @param flowField Flow field towards the player, used by
+ * PathfindingMode::FlowField. The owner keeps it up to date.
+ * @param hierarchicalMap Graph of cluster entrances, used by
+ * PathfindingMode::Hierarchical. The owner keeps it up to date.
  */
-Follower::Follower(float posX, float posY, float velX, float velY,
-                   std::vector<std::vector<Tile>> *map, Player *player,
-                   Window *window)
-    : WallBoundEntity(posX, posY, 16, 16, velX, velY, map, NULL, window),
-      player(player) {
-    // Load follower texture
-    this->texture = window->loadTexture("res/img/Steven.png");
+void Follower::setPathfindingMode(PathfindingMode mode, FlowField *flowField,
+                                  HierarchicalMap *hierarchicalMap) {
+    this->pathfindingMode = mode;
+    this->flowField = flowField;
+    this->hierarchicalMap = hierarchicalMap;
 }
 
 /**
- * Update the follower's velocity based on player's position using
- * pathfinding.
+ * Find the tile to move to next on the way to the player.
+ *
+ * @param followerTile Index of the tile the follower is on.
+ * @param playerTile Index of the tile the player is on.
+ * @return Index of the next tile, or -1 if there is nowhere to go.
  */
-void Follower::updateVelocity() {
-    this->velocity.x = 0;
-    this->velocity.y = 0;
-
-    // Calculate current follower position on the map. Get the tile it is
-    // currently on
-    int followerX = round(this->position.x / TILE_SIZE);
-    int followerY = round(this->position.y / TILE_SIZE);
-    Tile *followerTile = &(*this->map)[followerY][followerX];
-
-    // Calculate current follower position on the map. Get the tile it is
-    // currently on
-    int playerX = round(this->player->getPosition()->x / TILE_SIZE);
-    int playerY = round(this->player->getPosition()->y / TILE_SIZE);
-    Tile *playerTile = &(*this->map)[playerY][playerX];
-
-    // Handle the case where rounding errors cause the playerTile to be an
-    // adjacent wall
-    if (playerTile->getIsWall()) {
-        int directionsX[] = {0, 0, -1, 1};
-        int directionsY[] = {-1, 1, 0, 0};
-
-        // Search adjacent cells
-        for (int i = 0; i < 4; ++i) {
-            // Move one space either up, down, left, or right
-            int newX = playerX + directionsX[i];
-            int newY = playerY + directionsY[i];
-
-            // Check if the new coordinates are within the map boundaries
-            if (newX >= 0 && newX < MAP_SIZE && newY >= 0 && newY < MAP_SIZE) {
-                Tile *adjacentTile = &(*this->map)[newY][newX];
-
-                // Check if the adjacent tile is not a wall
-                if (!adjacentTile->getIsWall()) {
-                    playerTile = adjacentTile;
-                }
-            }
-        }
+int Follower::findNextTile(int followerTile, int playerTile) {
+    PROFILE_SCOPE("Follower::findNextTile");
+
+    // The shared field can only be used while it leads to the player
+    if (this->pathfindingMode == PathfindingMode::FlowField &&
+        this->flowField != nullptr &&
+        this->flowField->getGoal() == playerTile) {
+        return this->flowField->getNextStep(followerTile);
     }
 
-    // Find the next tile in the path using pathfinding
-    Tile *nextTile =
-        findPath(followerTile, playerTile, this->map)[followerTile];
-
-    if (nextTile == nullptr)
-        return;
+    if (this->pathfindingMode == PathfindingMode::Hierarchical &&
+        this->hierarchicalMap != nullptr) {
+        return this->hierarchicalSearch.findNextStep(followerTile, playerTile,
+                                                     this->hierarchicalMap);
+    }
 
-    // Update follower velocity to be in the direction of the next tile
-    if (nextTile->getPosition()->x / 16 > this->position.x / 16) {
-        this->velocity.x = FOLLOWER_BASE_VELOCITY;
-    } else if (nextTile->getPosition()->x / 16 < this->position.x / 16) {
-        this->velocity.x = -FOLLOWER_BASE_VELOCITY;
+    if (this->pathfindingMode == PathfindingMode::JumpPoint) {
+        return this->jumpPointSearch.findNextStep(followerTile, playerTile,
+                                                  this->map);
     }
 
-    if (nextTile->getPosition()->y / 16 > this->position.y / 16) {
-        this->velocity.y = FOLLOWER_BASE_VELOCITY;
-    } else if (nextTile->getPosition()->y / 16 < this->position.y / 16) {
-        this->velocity.y = -FOLLOWER_BASE_VELOCITY;
+    if (this->pathfindingMode == PathfindingMode::Incremental) {
+        return this->incrementalSearch.findNextStep(followerTile, playerTile,
+                                                    this->map);
     }
+
+    return this->pathSearch.findNextStep(followerTile, playerTile, this->map);
+}
+
+/**
+ * Gets the open tile the follower is standing on, as WallBoundEntity::getTile
+ * does for entities of their own.
+ *
+ * @return Index of the tile in the map, or -1 if there is no open tile nearby.
+ */
+int Follower::getTile() {
+    int x = round(this->bodies->getX(this->index) / TILE_SIZE);
+    int y = round(this->bodies->getY(this->index) / TILE_SIZE);
+
+    return this->map->findOpenNeighbor(x, y);
 }
 
 /**
- * Update the follower's position and render it.
+ * Decide where the follower moves this simulation tick, by setting its
+ * velocity towards the next tile on the way to the player. The body is moved
+ * later along with the rest of the horde. Only the follower's own velocity is
+ * changed, so followers of the same level can plan on different threads at
+ * once while nothing else changes.
  */
-void Follower::update() {
-    // Update follower velocity based on player's position
-    this->updateVelocity();
+void Follower::plan() {
+    float velocityX = 0;
+    float velocityY = 0;
+
+    // Get the tiles the follower and the player are currently on
+    int followerTile = this->getTile();
+    int playerTile = this->player->getTile();
+
+    // Find the next tile in the path using pathfinding
+    int nextTile = -1;
+    if (followerTile != -1 && playerTile != -1) {
+        nextTile = this->findNextTile(followerTile, playerTile);
+    }
+
+    if (nextTile != -1) {
+        int nextX = nextTile % this->map->getWidth();
+        int nextY = nextTile / this->map->getWidth();
+        float x = this->bodies->getX(this->index);
+        float y = this->bodies->getY(this->index);
+
+        // Set the velocity to be in the direction of the next tile
+        if (nextX * TILE_SIZE > x) {
+            velocityX = FOLLOWER_BASE_VELOCITY;
+        } else if (nextX * TILE_SIZE < x) {
+            velocityX = -FOLLOWER_BASE_VELOCITY;
+        }
 
-    // Move the follower
-    this->move();
+        if (nextY * TILE_SIZE > y) {
+            velocityY = FOLLOWER_BASE_VELOCITY;
+        } else if (nextY * TILE_SIZE < y) {
+            velocityY = -FOLLOWER_BASE_VELOCITY;
+        }
+    }
 
-    // Render the follower
-    this->render();
+    this->bodies->setVelocity(this->index, velocityX, velocityY);
 }
@@ -2,22 +2,9 @@
 
 #include "Entities/Player.hpp"
 #include "Entities/WallBoundEntity.hpp"
-#include "Game/Game.hpp"
 #include "Util/Constants.hpp"
 #include "Util/Window.hpp"
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_image.h>
-
-/**
- * Constructor for Player class with a Window pointer.
- *
- * @param window Pointer to the game window.
- */
-Player::Player(Window *window)
-    : WallBoundEntity(0, 0, 0, 0, 0, 0, NULL, NULL, window) {
-    // Load player texture
-    this->texture = window->loadTexture("res/img/MapPlayer16.png");
-}
+#include <cmath>
 
 /**
  * Constructor for Player class with specific parameters.
@@ -26,22 +13,30 @@ Player::Player(Window *window)
  * @param posY Initial Y-coordinate.
  * @param velX Initial X velocity.
  * @param velY Initial Y velocity.
- * @param map Pointer to the game map.
+ * @param map Pointer to the grid of walls.
  * @param window Pointer to the game window.
  */
 Player::Player(float posX, float posY, float velX, float velY,
-               std::vector<std::vector<Tile>> *map, Window *window)
+               TileGrid *map, Window *window)
     : WallBoundEntity(posX, posY, 16, 16, velX, velY, map, NULL, window),
-      numKeys(0) {
+      numKeys(0), input(InputState{0}) {
     // Load player texture
-    this->texture = window->loadTexture("res/img/MapPlayer16.png");
+    this->setSprite("res/img/MapPlayer16.png");
+    this->layer = ENTITY_LAYER;
 }
 
 /**
- * Updates the player's position and handles keyboard input.
+ * Sets the buttons held for the next tick.
+ *
+ * @param input The input to apply when the player is next updated.
+ */
+void Player::setInput(const InputState &input) { this->input = input; }
+
+/**
+ * Updates the player's position by one simulation tick based on its input.
  */
 void Player::update() {
-    const Uint8 *keystate = SDL_GetKeyboardState(NULL);
+    this->savePreviousPosition();
 
     /*
      Calculate the angle in radians based on the player's current frame
@@ -66,19 +61,19 @@ void Player::update() {
     */
 
     // Move forward on W pressed
-    if (keystate[SDL_SCANCODE_W]) {
+    if (this->input.isHeld(INPUT_FORWARD)) {
         xVelocity = PLAYER_BASE_VELOCITY * cos(theta);
         yVelocity = PLAYER_BASE_VELOCITY * sin(theta);
     }
 
     // Move back on S pressed
-    if (keystate[SDL_SCANCODE_S]) {
+    if (this->input.isHeld(INPUT_BACK)) {
         xVelocity = -PLAYER_BASE_VELOCITY * cos(theta);
         yVelocity = -PLAYER_BASE_VELOCITY * sin(theta);
     }
 
     // Move right on D pressed
-    if (keystate[SDL_SCANCODE_D]) {
+    if (this->input.isHeld(INPUT_RIGHT)) {
         // Get normal angle to move horizontally
         theta += M_PI_2;
         xVelocity = PLAYER_BASE_VELOCITY * cos(theta);
@@ -86,7 +81,7 @@ void Player::update() {
     }
 
     // Move left on A pressed
-    if (keystate[SDL_SCANCODE_A]) {
+    if (this->input.isHeld(INPUT_LEFT)) {
         // Get normal angle to move horizontally
         theta -= M_PI_2;
         xVelocity = PLAYER_BASE_VELOCITY * cos(theta);
@@ -94,7 +89,7 @@ void Player::update() {
     }
 
     // Rotate right on right arrow pressed
-    if (keystate[SDL_SCANCODE_RIGHT]) {
+    if (this->input.isHeld(INPUT_ROTATE_RIGHT)) {
         // Change the current frame from the texture file to rotate the Player
         this->getCurrentFrame()->x -= 16;
         if (this->getCurrentFrame()->x < 0) {
@@ -103,7 +98,7 @@ void Player::update() {
     }
 
     // Rotate left on left arrow pressed
-    if (keystate[SDL_SCANCODE_LEFT]) {
+    if (this->input.isHeld(INPUT_ROTATE_LEFT)) {
         // Change the current frame from the texture file to rotate the Player
         this->getCurrentFrame()->x += 16;
         if (this->getCurrentFrame()->x + 16 > 512) {
@@ -117,9 +112,6 @@ void Player::update() {
 
     // Move the player
     this->move();
-
-    // Render the player
-    this->render();
 }
 
 /**
@@ -1,9 +1,10 @@
 // Represents entities constrained by walls in a Tile-based map.
 
 #include "Entities/WallBoundEntity.hpp"
-#include "Maze/Tile.hpp"
-#include <cstdio>
-#include <vector>
+#include "Maze/TileGrid.hpp"
+#include "Util/Constants.hpp"
+#include "Util/Profiler.hpp"
+#include <cmath>
 
 /**
  * Constructs a WallBoundEntity with the specified parameters.
@@ -14,42 +15,74 @@
  * @param height    The height of the entity.
  * @param velX      The initial velocity along the x-axis.
  * @param velY      The initial velocity along the y-axis.
- * @param map       A pointer to the Tile-based map.
+ * @param map       A pointer to the grid of walls.
  * @param texture   The SDL texture for rendering.
  * @param window    The window in which the entity exists.
  */
 WallBoundEntity::WallBoundEntity(float posX, float posY, float width,
                                  float height, float velX, float velY,
-                                 std::vector<std::vector<Tile>> *map,
-                                 SDL_Texture *texture, Window *window)
+                                 TileGrid *map, SDL_Texture *texture,
+                                 Window *window)
     : Entity(posX, posY, width, height, velX, velY, texture, window), map(map) {
 }
 
+/**
+ * Gets the open tile the entity is standing on. Rounding errors can place an
+ * entity that is pressed against a wall on the wall itself, in which case an
+ * open neighbour of that wall is used instead.
+ *
+ * @return Index of the tile in the map, or -1 if there is no open tile nearby.
+ */
+int WallBoundEntity::getTile() {
+    int x = round(this->position.x / TILE_SIZE);
+    int y = round(this->position.y / TILE_SIZE);
+
+    return this->map->findOpenNeighbor(x, y);
+}
+
+/**
+ * Checks whether the entity overlaps any wall tile. Only the tiles covered by
+ * the entity's bounding box are looked at, so the cost does not depend on the
+ * size of the map.
+ *
+ * @return True if the entity is inside a wall, false otherwise.
+ */
+bool WallBoundEntity::isCollidingWithWall() {
+    // Range of tiles the bounding box overlaps. Boxes that only touch a tile's
+    // edge do not collide with it, so the right and bottom edges round up
+    int left = floor(this->position.x / TILE_SIZE);
+    int top = floor(this->position.y / TILE_SIZE);
+    int right = ceil((this->position.x + this->dimensions.x) / TILE_SIZE);
+    int bottom = ceil((this->position.y + this->dimensions.y) / TILE_SIZE);
+
+    for (int y = top; y < bottom; y++) {
+        for (int x = left; x < right; x++) {
+            if (this->map->isWall(x, y)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 /**
  * Moves the entity, adjusting its position based on collisions with walls.
  */
 void WallBoundEntity::move() {
+    PROFILE_SCOPE("WallBoundEntity::move");
+
     this->position.x += this->velocity.x;
 
-    for (std::vector<Tile> row : *this->map) {
-        for (Tile tile : row) {
-            if (tile.getIsWall() && this->isCollidingWith(&tile)) {
-                this->position.x -= this->velocity.x;
-                this->velocity.x = 0;
-                break;
-            }
-        }
+    if (this->isCollidingWithWall()) {
+        this->position.x -= this->velocity.x;
+        this->velocity.x = 0;
     }
 
     this->position.y += this->velocity.y;
 
-    for (std::vector<Tile> row : *this->map) {
-        for (Tile tile : row) {
-            if (tile.getIsWall() && this->isCollidingWith(&tile)) {
-                this->position.y -= this->velocity.y;
-                this->velocity.y = 0;
-                break;
-            }
-        }
+    if (this->isCollidingWithWall()) {
+        this->position.y -= this->velocity.y;
+        this->velocity.y = 0;
     }
 }
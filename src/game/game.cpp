@@ -3,12 +3,16 @@
 #include "Game/Game.hpp"
 #include "Entities/Entity.hpp"
 #include "Game/Level.hpp"
+#include "Game/LevelLoader.hpp"
+#include "Game/Replay.hpp"
 #include "UI/Button.hpp"
 #include "UI/Screen.hpp"
 #include "UI/Sprite.hpp"
 #include "UI/Text.hpp"
 #include "Util/Constants.hpp"
-#include <SDL2/SDL_ttf.h>
+#include "Util/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <iostream>
 #include <string>
@@ -20,15 +24,40 @@
  */
 Game::Game(const char *name, unsigned int fps)
     : running(false), frameDelay(1000 / fps), inGame(false),
-      window(Window(name, MAP_SIZE * 16, MAP_SIZE * 16)),
-      currentScreen(nullptr), currentLevel(nullptr) {}
+      window(Window(name, VIEW_SIZE * 16, VIEW_SIZE * 16)),
+      currentScreen(nullptr), currentLevel(nullptr),
+      levelErrorText(nullptr), hud(&this->window),
+#ifdef PROFILING
+      profilerOverlay(&this->window),
+#endif
+      isReplaying(false) {
+    PROFILE_THREAD_NAME("Game");
+}
 
 /**
- * Initialize the game, including SDL and game screens.
+ * Record every level played from now on. Each finished level overwrites the
+ * file with its own recording.
+ *
+ * @param filePath The path to write recordings to.
  */
-void Game::init() {
-    initSdl(); // Initialize SDL
+void Game::setRecordPath(const char *filePath) { this->recordPath = filePath; }
+
+/**
+ * Watch a replay in real time instead of playing. The replay's level starts
+ * as soon as the game does.
+ *
+ * @param filePath The path to the replay file.
+ * @return False if the replay could not be loaded.
+ */
+bool Game::watchReplay(const char *filePath) {
+    this->isReplaying = this->replay.load(filePath);
+    return this->isReplaying;
+}
 
+/**
+ * Initialize the game screens and run the game until it is closed.
+ */
+void Game::init() {
     this->running = true; // Set the game to running state
 
     // Define button dimensions
@@ -39,11 +68,11 @@ void Game::init() {
     auto onGoToLevelButtonClick = [this]() {
         this->currentScreen = screens["Levels"];
     };
-    Text title("IT FOLLOWS", 25, MAP_PIXEL_SIZE / 2, (MAP_PIXEL_SIZE / 5),
+    Text title("IT FOLLOWS", 25, VIEW_PIXEL_SIZE / 2, (VIEW_PIXEL_SIZE / 5),
                &this->window);
     Button goToLevelsButton(
-        "Levels", 15, (MAP_PIXEL_SIZE / 2) - (buttonWidth / 2),
-        (MAP_PIXEL_SIZE / 2) - (buttonHeight / 2), buttonWidth, buttonHeight,
+        "Levels", 15, (VIEW_PIXEL_SIZE / 2) - (buttonWidth / 2),
+        (VIEW_PIXEL_SIZE / 2) - (buttonHeight / 2), buttonWidth, buttonHeight,
         onGoToLevelButtonClick, &this->window);
     std::vector<Sprite *> titleScreenSprites = {&title, &goToLevelsButton};
     Screen titleScreen(&titleScreenSprites);
@@ -53,19 +82,19 @@ void Game::init() {
     auto onReturnToTitleClick = [this]() {
         this->currentScreen = screens["Title"];
     };
-    Text winText("You escaped!", 25, (MAP_PIXEL_SIZE / 2), (MAP_PIXEL_SIZE / 5),
-                 &this->window);
-    Button goToTitleButton("Back", 15, (MAP_PIXEL_SIZE / 2) - (buttonWidth / 2),
-                           (MAP_PIXEL_SIZE / 2) - (buttonHeight / 2),
-                           buttonWidth, buttonHeight, onReturnToTitleClick,
-                           &this->window);
+    Text winText("You escaped!", 25, (VIEW_PIXEL_SIZE / 2),
+                 (VIEW_PIXEL_SIZE / 5), &this->window);
+    Button goToTitleButton(
+        "Back", 15, (VIEW_PIXEL_SIZE / 2) - (buttonWidth / 2),
+        (VIEW_PIXEL_SIZE / 2) - (buttonHeight / 2), buttonWidth, buttonHeight,
+        onReturnToTitleClick, &this->window);
     std::vector<Sprite *> winScreenSprites = {&goToTitleButton, &winText};
     Screen winScreen(&winScreenSprites);
     screens["Win"] = &winScreen;
 
     // Lose screen
-    Text loseText("It got you :)", 25, (MAP_PIXEL_SIZE / 2),
-                  (MAP_PIXEL_SIZE / 5), &this->window);
+    Text loseText("It got you :)", 25, (VIEW_PIXEL_SIZE / 2),
+                  (VIEW_PIXEL_SIZE / 5), &this->window);
     std::vector<Sprite *> loseScreenSprites = {&goToTitleButton, &loseText};
     Screen loseScreen(&loseScreenSprites);
     screens["Lose"] = &loseScreen;
@@ -73,16 +102,21 @@ void Game::init() {
     // Level screen
     float gap = 15.0f;
     float columnHeight = NUM_LEVELS * (80 + gap);
-    float startY = (MAP_PIXEL_SIZE / 2) - (columnHeight / 2);
-    float centerX = (MAP_PIXEL_SIZE / 2) - (buttonWidth / 2);
+    float startY = (VIEW_PIXEL_SIZE / 2) - (columnHeight / 2);
+    float centerX = (VIEW_PIXEL_SIZE / 2) - (buttonWidth / 2);
 
     std::vector<Sprite *> levels;
 
+    // Level buttons live as long as the screens, and are never moved once
+    // the screen points at them
+    std::vector<Button> levelButtons;
+    levelButtons.reserve(NUM_LEVELS);
+
     // Create buttons for each level
     for (int i = 1; i <= NUM_LEVELS; i++) {
+        // The levels screen stays up until the level has finished loading
         auto onGoToLevelButtonClick = [i, this]() {
-            this->currentScreen = nullptr;
-            this->currentLevel = nullptr;
+            this->endLevel();
             this->inGame = true;
             this->currentLevelIndex = i;
         };
@@ -91,61 +125,122 @@ void Game::init() {
 
         std::string levelText = "Level " + std::to_string(i);
 
-        Button *levelButton =
-            new Button(levelText, 12, centerX, buttonY, buttonWidth,
-                       buttonHeight, onGoToLevelButtonClick, &this->window);
+        levelButtons.emplace_back(levelText, 12, centerX, buttonY, buttonWidth,
+                                  buttonHeight, onGoToLevelButtonClick,
+                                  &this->window);
+
+        // Start loading the level as soon as it looks likely to be picked
+        levelButtons.back().setOnHover(
+            [i, this]() { this->levelLoader.preload(i); });
 
-        levels.push_back(levelButton);
+        levels.push_back(&levelButtons.back());
     }
 
+    // Empty until a level fails to load
+    Text levelErrorText("", 12, VIEW_PIXEL_SIZE / 2, startY / 2,
+                        &this->window);
+    this->levelErrorText = &levelErrorText;
+    levels.push_back(&levelErrorText);
+
     Screen levelsScreen(&levels);
     this->screens["Levels"] = &levelsScreen;
 
     this->currentScreen = this->screens["Title"];
 
-    Uint32 frameStart;
-    int frameTime;
+    // The first level is the most likely one to be played first
+    this->levelLoader.preload(1);
+
+    if (this->isReplaying) {
+        this->inGame = true;
+        this->currentLevelIndex = this->replay.getLevelIndex();
+    }
+
+    /*
+     The simulation advances in fixed ticks of 1 / TICKS_PER_SECOND seconds,
+     however long frames take. Elapsed time is accumulated in performance
+     counter units scaled by TICKS_PER_SECOND, so a tick is exactly `frequency`
+     units long and no time is lost to rounding. Whatever is left over after
+     the ticks is how far the frame is towards the next tick, which entities
+     use to interpolate their drawn positions
+    */
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 maxAccumulator = frequency * MAX_TICKS_PER_FRAME;
+    Uint64 accumulator = 0;
+    Uint64 previousCounter = SDL_GetPerformanceCounter();
 
     // Main game loop
     while (this->running) {
-        frameStart = SDL_GetTicks();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        accumulator += (frameStart - previousCounter) * TICKS_PER_SECOND;
+        previousCounter = frameStart;
+
+        // Drop time the simulation cannot catch up on rather than falling
+        // further behind every frame
+        if (accumulator > maxAccumulator) {
+            accumulator = maxAccumulator;
+        }
 
         handleEvents(); // Handle SDL events
-        update();       // Update game state
-        render();       // Render the game
 
-        frameTime = SDL_GetTicks() - frameStart;
+        while (accumulator >= frequency) {
+            update(); // Update game state
+            accumulator -= frequency;
+        }
+
+        this->window.setInterpolation(double(accumulator) / frequency);
+        render(); // Render the game
+
+        Uint64 frameTime = (SDL_GetPerformanceCounter() - frameStart) * 1000 /
+                           SDL_GetPerformanceFrequency();
 
         // Cap the frame rate
-        if (this->frameDelay > frameTime) {
+        if (this->frameDelay > (int)frameTime) {
             SDL_Delay(this->frameDelay - frameTime);
         }
     }
+
+    // Keep the recording of a level that was quit part way through
+    if (this->inGame && this->currentLevel != nullptr) {
+        this->finishSession();
+    }
+}
+
+/**
+ * Destroy the current level, if any, and empty the arena it was allocated
+ * from. The arena keeps its memory for the next level.
+ */
+void Game::endLevel() {
+    if (this->currentLevel != nullptr) {
+        this->currentLevel->~Level();
+        this->currentLevel = nullptr;
+    }
+
+    this->levelArena.reset();
 }
 
 /**
- * Initialize SDL, SDL Image, and SDL TTF.
+ * Wrap up the input of the level just played: save it when recording, or
+ * check it played out the same way as the replay being watched.
  */
-void Game::initSdl() {
-    if (SDL_Init(SDL_INIT_VIDEO) != 0)
-        std::cout << "SDL_Init HAS FAILED. SDL_ERROR: " << SDL_GetError()
-                  << "\n";
-
-    if (!IMG_Init(IMG_INIT_PNG))
-        std::cout << "IMG_Init HAS FAILED. SDL_ERROR: " << SDL_GetError()
-                  << "\n";
-
-    if (TTF_Init() != 0) {
-        std::cout << "TTF_Init HAS FAILED. SDL_ERROR: " << SDL_GetError()
-                  << "\n";
+void Game::finishSession() {
+    if (this->isReplaying) {
+        this->replay.verify(this->currentLevel->getChecksum(),
+                            this->currentLevel->getTickCount());
+        this->isReplaying = false;
+    } else if (!this->recordPath.empty()) {
+        this->recording.finish(this->currentLevel->getChecksum());
+        this->recording.save(this->recordPath.c_str());
     }
 }
 
 /**
  * Handle SDL events such as quitting the game or returning to the title
- * screen.
+ * screen. Profiling builds also show the profiler overlay on F3 and write a
+ * trace of the last few seconds on F4.
  */
 void Game::handleEvents() {
+    PROFILE_SCOPE("Game::handleEvents");
+
     SDL_Event event;
 
     while (SDL_PollEvent(&event)) {
@@ -153,53 +248,258 @@ void Game::handleEvents() {
         case SDL_QUIT: // Window closed
             this->running = false;
             break;
+#ifdef PROFILING
+        case SDL_KEYDOWN:
+            if (event.key.repeat != 0)
+                break;
+
+            if (event.key.keysym.sym == SDLK_F3) {
+                this->profilerOverlay.toggle();
+            } else if (event.key.keysym.sym == SDLK_F4) {
+                Profiler::writeTrace(PROFILE_TRACE_PATH);
+            }
+            break;
+#endif
         }
     }
 }
 
 /**
- * Update the game state, including screens and levels.
+ * Update the game state by one simulation tick, starting the chosen level once
+ * it has loaded and checking whether it has been won or lost.
  */
 void Game::update() {
-    this->window.clear(); // Clear the window
+    PROFILE_SCOPE("Game::update");
 
-    if (this->inGame) {
-        if (this->currentLevel == nullptr) {
-            std::string levelPath = "res/levels/level" +
-                                    std::to_string(this->currentLevelIndex) +
-                                    ".txt";
-            this->currentLevel =
-                std::make_unique<Level>(levelPath.c_str(), &this->window);
-        }
+    if (!this->inGame)
+        return;
+
+    if (this->currentLevel == nullptr) {
+        std::unique_ptr<PreparedLevel> level =
+            this->levelLoader.take(this->currentLevelIndex);
+
+        // Keep showing the last screen until the level is ready
+        if (level == nullptr)
+            return;
 
-        this->currentLevel->update(); // Update the current level
+        // Go back to picking a level, saying which one could not be played
+        if (!level->isLoaded) {
+            std::cout << "FAILED TO LOAD LEVEL " << this->currentLevelIndex
+                      << "\n";
+            this->levelErrorText->setText(
+                "Level " + std::to_string(this->currentLevelIndex) +
+                " failed to load");
 
-        // Check win condition
-        if (this->currentLevel->getPlayer()->getNumKeys() ==
-            this->currentLevel->getNumKeys()) {
-            this->currentScreen = this->screens["Win"];
             this->inGame = false;
+            this->isReplaying = false;
+            this->currentScreen = this->screens["Levels"];
+            return;
         }
 
-        // Check lose condition
-        if (this->currentLevel->getPlayer()->isCollidingWith(
-                this->currentLevel->getFollower())) {
-            this->currentScreen = this->screens["Lose"];
-            this->inGame = false;
+        this->levelErrorText->setText("");
+
+        this->currentLevel = this->levelArena.create<Level>(
+            level.get(), &this->window, &this->levelArena);
+
+        // Get ready for the level being restarted or the next one
+        this->levelLoader.preload(this->currentLevelIndex);
+        if (this->currentLevelIndex < NUM_LEVELS) {
+            this->levelLoader.preload(this->currentLevelIndex + 1);
         }
+
+        if (this->isReplaying) {
+            this->replayInput.start(&this->replay);
+        } else {
+            this->recording.start(this->currentLevelIndex, 0);
+        }
+    }
+
+    // Update the current level with the recorded input when watching a
+    // replay, and the keyboard otherwise
+    InputState input;
+    if (this->isReplaying) {
+        input = this->replayInput.poll();
     } else {
-        this->currentScreen->update(); // Update the current screen
+        input = this->keyboard.poll();
+
+        if (!this->recordPath.empty()) {
+            this->recording.record(input);
+        }
+    }
+
+    this->currentLevel->update(input);
+
+    // A replay is over once its input runs out, even if the level is not
+    LevelState state = this->currentLevel->getState();
+    bool isReplayOver = this->isReplaying && this->replayInput.isFinished();
+
+    if (state == LevelState::Playing && !isReplayOver)
+        return;
+
+    this->finishSession();
+    this->inGame = false;
+
+    // Check win and lose conditions
+    if (state == LevelState::Won) {
+        this->currentScreen = this->screens["Win"];
+    } else if (state == LevelState::Lost) {
+        this->currentScreen = this->screens["Lose"];
+    } else {
+        this->currentScreen = this->screens["Title"];
     }
 }
 
 /**
- * Render the game.
+ * Render the game: the level being played with the HUD over it, or the current
+ * screen. Screens also handle their buttons here, once per frame.
  */
 void Game::render() {
+    PROFILE_SCOPE("Game::render");
+
+    this->window.clear(); // Clear the window
+
+    if (this->inGame && this->currentLevel != nullptr) {
+        this->currentLevel->render();
+
+        this->hud.update(this->currentLevel->getPlayer()->getNumKeys(),
+                         this->currentLevel->getNumKeys(),
+                         this->currentLevel->getTickCount());
+    } else {
+        // Screens are drawn in window coordinates
+        this->window.setCamera(0, 0);
+        this->currentScreen->update(); // Update the current screen
+    }
+
+#ifdef PROFILING
+    this->profilerOverlay.update();
+#endif
+
     this->window.display(); // Display the window
 }
 
+/**
+ * Prints how a level simulated without a window ended and how quickly it ran.
+ *
+ * @param levelIndex The number of the level, starting from 1.
+ * @param level The level after its last tick.
+ * @param seconds How long the simulation took.
+ */
+void printHeadlessResult(int levelIndex, Level *level, double seconds) {
+    const char *result = level->getState() == LevelState::Won    ? "won"
+                         : level->getState() == LevelState::Lost ? "lost"
+                                                                 : "unfinished";
+
+    printf("level %d: %s after %d ticks, %d/%d keys (%.0f ticks/s)\n",
+           levelIndex, result, level->getTickCount(),
+           level->getPlayer()->getNumKeys(), level->getNumKeys(),
+           level->getTickCount() / std::max(seconds, 1e-9));
+}
+
+/**
+ * Plays a level without a window, renderer or textures, as fast as possible,
+ * with a bot holding random buttons. SDL is never initialized, so this runs on
+ * machines without a display.
+ *
+ * @param levelIndex The number of the level to play, starting from 1.
+ * @param maxTicks Most simulation ticks to run before giving up.
+ * @param seed Seed for the bot's random input.
+ * @param recordPath The path to record the bot's input to, or nullptr to not
+ * record it.
+ * @return 0 if the level was played, 1 if it or the recording failed.
+ */
+int Game::runHeadless(int levelIndex, int maxTicks, unsigned int seed,
+                      const char *recordPath) {
+    PreparedLevel prepared;
+    if (!prepared.load(LevelLoader::getLevelPath(levelIndex).c_str()))
+        return 1;
+
+    Arena arena;
+    Level level(&prepared, nullptr, &arena);
+    RandomInput input(seed);
+
+    Replay recording;
+    recording.start(levelIndex, seed);
+
+    auto begin = std::chrono::steady_clock::now();
+
+    while (level.getState() == LevelState::Playing &&
+           level.getTickCount() < maxTicks) {
+        InputState tickInput = input.poll();
+
+        if (recordPath != nullptr) {
+            recording.record(tickInput);
+        }
+
+        level.update(tickInput);
+    }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+
+    printHeadlessResult(levelIndex, &level, seconds);
+
+#ifdef PROFILING
+    Profiler::writeTrace(PROFILE_TRACE_PATH);
+#endif
+
+    if (recordPath != nullptr) {
+        recording.finish(level.getChecksum());
+        if (!recording.save(recordPath))
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Plays a replay back without a window as fast as possible, checking that it
+ * ends in the same state it was recorded in.
+ *
+ * @param filePath The path to the replay file.
+ * @return 0 if the replay matched, 1 if it could not be played, and 2 if it
+ * diverged from the recording.
+ */
+int Game::runReplay(const char *filePath) {
+    Replay replay;
+    if (!replay.load(filePath))
+        return 1;
+
+    int levelIndex = replay.getLevelIndex();
+
+    PreparedLevel prepared;
+    if (!prepared.load(LevelLoader::getLevelPath(levelIndex).c_str()))
+        return 1;
+
+    Arena arena;
+    Level level(&prepared, nullptr, &arena);
+    ReplayInput input;
+    input.start(&replay);
+
+    auto begin = std::chrono::steady_clock::now();
+
+    while (level.getState() == LevelState::Playing && !input.isFinished()) {
+        level.update(input.poll());
+    }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+
+    printHeadlessResult(levelIndex, &level, seconds);
+
+#ifdef PROFILING
+    Profiler::writeTrace(PROFILE_TRACE_PATH);
+#endif
+
+    return replay.verify(level.getChecksum(), level.getTickCount()) ? 0 : 2;
+}
+
 /**
  * Destructor for the Game class.
  */
-Game::~Game() { SDL_Quit(); }
+Game::~Game() {
+    // The level's textures must be destroyed while the renderer exists. The
+    // window and then SDL itself are shut down after this, as members
+    this->endLevel();
+}
@@ -0,0 +1,68 @@
+// Heads-up display drawn over a level: keys collected, time spent in the
+// level and frames per second
+
+#include "Game/Hud.hpp"
+#include "UI/GlyphText.hpp"
+#include "Util/Constants.hpp"
+#include <cstdio>
+
+// Point size of the HUD font
+const int HUD_FONT_SIZE = 8;
+
+// Pixels between the HUD and the edges of the window
+const int HUD_MARGIN = 4;
+
+// Milliseconds frames are counted over before the FPS counter changes
+const Uint32 FPS_PERIOD = 1000;
+
+/**
+ * Constructor for the Hud class.
+ *
+ * @param window The Window object the HUD is drawn to.
+ */
+Hud::Hud(Window *window)
+    : keysText(HUD_FONT_SIZE, HUD_MARGIN, HUD_MARGIN, window),
+      timeText(HUD_FONT_SIZE, HUD_MARGIN, HUD_MARGIN + 2 * HUD_FONT_SIZE,
+               window),
+      fpsText(HUD_FONT_SIZE, HUD_MARGIN, HUD_MARGIN, window),
+      fpsStartTicks(0), frameCount(0), fps(0) {}
+
+/**
+ * Refreshes and draws the HUD. Called once per frame, which is also how the
+ * frame rate is measured. Formatting the numbers never allocates.
+ *
+ * @param keysCollected Number of keys the player has picked up.
+ * @param numKeys Number of keys in the level.
+ * @param levelTicks Number of simulation ticks since the level started.
+ */
+void Hud::update(int keysCollected, int numKeys, int levelTicks) {
+    Uint32 ticks = SDL_GetTicks();
+
+    this->frameCount++;
+    if (ticks - this->fpsStartTicks >= FPS_PERIOD) {
+        this->fps = this->frameCount * 1000 / (ticks - this->fpsStartTicks);
+        this->fpsStartTicks = ticks;
+        this->frameCount = 0;
+    }
+
+    char buffer[32];
+    int elapsed = levelTicks * 1000 / TICKS_PER_SECOND;
+
+    snprintf(buffer, sizeof(buffer), "KEYS %d/%d", keysCollected, numKeys);
+    this->keysText.setText(buffer);
+
+    snprintf(buffer, sizeof(buffer), "TIME %d.%d", elapsed / 1000,
+             elapsed / 100 % 10);
+    this->timeText.setText(buffer);
+
+    snprintf(buffer, sizeof(buffer), "FPS %d", this->fps);
+    this->fpsText.setText(buffer);
+
+    // Keep the FPS counter against the right edge of the window
+    this->fpsText.getPosition()->x =
+        VIEW_PIXEL_SIZE - HUD_MARGIN - this->fpsText.getTextWidth();
+
+    this->keysText.update();
+    this->timeText.update();
+    this->fpsText.update();
+}
@@ -2,122 +2,310 @@
 // a level like the map, player, and keys
 
 #include "Game/Level.hpp"
+#include "Game/LevelLoader.hpp"
+#include "Entities/EntityStorage.hpp"
 #include "Entities/Follower.hpp"
-#include "Maze/Key.hpp"
-#include "Maze/Tile.hpp"
+#include "Maze/LevelData.hpp"
+#include "Maze/TileGrid.hpp"
+#include "Maze/TileLayer.hpp"
+#include "Util/Arena.hpp"
 #include "Util/Constants.hpp"
+#include "Util/Profiler.hpp"
+#include "Util/SpatialHash.hpp"
+#include "Util/ThreadPool.hpp"
 #include "Util/Window.hpp"
-#include <fstream>
-#include <iostream>
-#include <sstream>
-#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
-// Constructor for the Level class
-Level::Level(const char *filePath, Window *window)
-    : numKeys(0), player(Player(window)), follower(Follower(window)) {
-
-    // Read the contents of the file into a string
-    std::ifstream fileStream(filePath);
-    std::stringstream stringStream;
-    stringStream << fileStream.rdbuf();
-    std::string contents = stringStream.str();
-
-    int currRow = 0;
-    int currCol = 0;
-
-    // Initialize the map with an empty vector for the first row
-    this->map.push_back(std::vector<Tile>());
-
-    // Loop through the contents of the file to create the level map
-    for (int i = 0; i < contents.length(); i++) {
-        if (contents[i] == ' ') {
-            continue; // Skip empty spaces
-        } else if (contents[i] == '\n') {
-            currRow++;
-            currCol = 0;
-            this->map.push_back(std::vector<Tile>()); // Move to the next row
-            continue;
-        }
+// Constructor for the Level class, placing everything where the level data
+// says it starts. The walls, entities, and followers' search tables are
+// allocated from the arena, which must outlive the level; the hierarchical
+// map is moved out of the prepared level. Without a window the level can only
+// be simulated, and nothing is loaded for drawing it
+Level::Level(PreparedLevel *level, Window *window, Arena *arena)
+    : map(level->data.map, arena), window(window), numKeys(0), keys(arena),
+      keyHash(arena),
+      player(level->data.player.x * 16, level->data.player.y * 16, 0, 0,
+             &this->map, window),
+      followerBodies(arena), followers(arena), followerHash(arena),
+      nearby(arena),
+      pathfindingMode(PathfindingMode::Incremental),
+      flowField(arena), flowFieldChangeCount(0),
+      hierarchicalMap(std::move(level->hierarchicalMap)), tickCount(0),
+      state(LevelState::Playing) {
+    const LevelData &data = level->data;
 
-        // Create Tile and Player objects based on the character in the file
-        if (contents[i] == '0') {
-            this->map[currRow].push_back(
-                Tile(16 * currCol, 16 * currRow, false, window));
-        } else if (contents[i] == '1') {
-            this->map[currRow].push_back(
-                Tile(16 * currCol, 16 * currRow, true, window));
-        } else if (contents[i] == 'P') {
-            this->player =
-                Player(currCol * 16, currRow * 16, 0, 0, &this->map, window);
-            this->map[currRow].push_back(
-                Tile(16 * currCol, 16 * currRow, false, window));
-        }
+    if (window != nullptr) {
+        this->tileLayer = std::make_unique<TileLayer>(&this->map, window);
+    }
 
-        currCol++;
+    // Every key shares one sprite, as does every follower. Headless levels go
+    // without them
+    TextureRegion keySprite = TextureRegion{NULL, SDL_Rect{0, 0, 0, 0}};
+    TextureRegion followerSprite = keySprite;
+    if (window != nullptr) {
+        keySprite = window->loadSprite("res/img/Key.png");
+        followerSprite = window->loadSprite("res/img/Steven.png");
     }
 
-    // Reset row and column counters for the second pass
-    currRow = 0;
-    currCol = 0;
-
-    int keyIndex = 0;
-
-    // Second pass to create keys and follower
-    for (int i = 0; i < contents.length(); i++) {
-        if (contents[i] == ' ') {
-            continue;
-        } else if (contents[i] == '\n') {
-            currRow++;
-            currCol = 0;
-            this->map.push_back(std::vector<Tile>());
-            continue;
-        }
+    this->keyHash.setBounds(this->map.getWidth() * TILE_SIZE,
+                            this->map.getHeight() * TILE_SIZE);
+    this->followerHash.setBounds(this->map.getWidth() * TILE_SIZE,
+                                 this->map.getHeight() * TILE_SIZE);
 
-        // Create Key and Follower objects based on the characters in the file
-        if (contents[i] == 'K') {
-            this->keys.push_back(Key(keyIndex, currCol * 16, currRow * 16,
-                                     &this->player, &this->keys, window));
-            this->map[currRow].push_back(
-                Tile(16 * currCol, 16 * currRow, false, window));
-            keyIndex++;
-            this->numKeys++;
-        } else if (contents[i] == 'F') {
-            this->follower = Follower(currCol * 16, currRow * 16, 0, 0,
-                                      &this->map, &this->player, window);
-            this->map[currRow].push_back(
-                Tile(16 * currCol, 16 * currRow, false, window));
-        }
+    this->keys.reserve(data.keys.size());
+    for (const LevelSpawn &spawn : data.keys) {
+        EntityHandle key = this->keys.create(spawn.x * 16, spawn.y * 16, 16,
+                                             16, keySprite, KEY_LAYER);
+        this->keyHash.insert(key.slot, spawn.x * 16, spawn.y * 16, 16, 16);
+        this->numKeys++;
+    }
+
+    // Followers of a horde all read their way from one flow field, rebuilt
+    // only when the player reaches a new tile, instead of each keeping a
+    // search of its own. A lone follower on a large map plans over cluster
+    // entrances instead of tile by tile
+    if (data.followers.size() > 1) {
+        this->pathfindingMode = PathfindingMode::FlowField;
+    } else if (level->isHierarchical) {
+        this->pathfindingMode = PathfindingMode::Hierarchical;
+        this->hierarchicalMap.setMap(&this->map);
+    }
 
-        currCol++;
+    // Followers never move in memory once created, since each of them keeps
+    // pointers into the level
+    this->followerBodies.reserve(data.followers.size());
+    this->followers.reserve(data.followers.size());
+    for (const LevelSpawn &spawn : data.followers) {
+        int index = this->followers.size();
+        this->followerBodies.create(spawn.x * 16, spawn.y * 16, 16, 16,
+                                    followerSprite, ENTITY_LAYER);
+        this->followers.emplace_back(&this->followerBodies, index, &this->map,
+                                     &this->player, arena);
+        this->followers.back().setPathfindingMode(
+            this->pathfindingMode, &this->flowField, &this->hierarchicalMap);
+        this->followerHash.insert(index, spawn.x * 16, spawn.y * 16, 16, 16);
     }
 }
 
 // Getter for the player object
 Player *Level::getPlayer() { return &this->player; }
 
-// Getter for the follower object
-Follower *Level::getFollower() { return &this->follower; }
+// Getter for the number of followers in the level
+int Level::getFollowerCount() { return this->followers.size(); }
+
+// Getter for one of the followers, in the order they appear in the level data
+Follower *Level::getFollower(int index) { return &this->followers[index]; }
 
 // Getter for the number of keys in the level
 int Level::getNumKeys() { return this->numKeys; }
 
-// Render the level by updating tiles, keys, player, and follower
+// Getter for the number of simulation ticks since the level started
+int Level::getTickCount() { return this->tickCount; }
+
+// Getter for whether the level has been won or lost
+LevelState Level::getState() { return this->state; }
+
+// Add a value's bytes to a 64-bit FNV-1a hash
+template <typename T> uint64_t hashValue(uint64_t hash, const T &value) {
+    const unsigned char *bytes = (const unsigned char *)&value;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3;
+    }
+
+    return hash;
+}
+
+// Hash of everything that changes while the level is played: the tick, the
+// outcome, where the player and followers are, which way the player faces,
+// and the keys left. Two runs of a level with the same input end with the
+// same checksum, so a replay that diverged can be told apart
+uint64_t Level::getChecksum() {
+    uint64_t hash = 0xcbf29ce484222325;
+
+    hash = hashValue(hash, this->tickCount);
+    hash = hashValue(hash, this->state);
+    hash = hashValue(hash, *this->player.getPosition());
+    hash = hashValue(hash, this->player.getCurrentFrame()->x);
+    hash = hashValue(hash, this->player.getNumKeys());
+
+    for (int i = 0; i < this->followerBodies.getSize(); i++) {
+        hash = hashValue(hash, this->followerBodies.getX(i));
+        hash = hashValue(hash, this->followerBodies.getY(i));
+    }
+
+    for (int i = 0; i < this->keys.getSize(); i++) {
+        hash = hashValue(hash, this->keys.getX(i));
+        hash = hashValue(hash, this->keys.getY(i));
+    }
+
+    return hash;
+}
+
+// Centre the camera on where the player is drawn, without scrolling past the
+// edges of the map. Maps smaller than the window stay in its top-left corner
+void Level::updateCamera() {
+    int maxX = this->map.getWidth() * TILE_SIZE - this->window->getWidth();
+    int maxY = this->map.getHeight() * TILE_SIZE - this->window->getHeight();
+
+    Vector2f position = this->player.getRenderPosition();
+    int x = round(position.x) + TILE_SIZE / 2 - this->window->getWidth() / 2;
+    int y = round(position.y) + TILE_SIZE / 2 - this->window->getHeight() / 2;
+
+    this->window->setCamera(std::max(0, std::min(x, maxX)),
+                            std::max(0, std::min(y, maxY)));
+}
+
+// Render the level by drawing the tiles, keys, player, and followers. Moving
+// entities are drawn between their positions before and after the last tick.
+// Only levels with a window can be rendered
 void Level::render() {
-    for (std::vector<Tile> row : this->map) {
-        for (Tile tile : row) {
-            tile.update();
+    PROFILE_SCOPE("Level::render");
+
+    this->updateCamera();
+    this->tileLayer->render();
+
+    this->keys.render(this->window);
+
+    this->player.render();
+
+    this->followerBodies.render(this->window);
+}
+
+// Keep the followers' shared navigation data up to date. The hierarchical map
+// repairs the clusters whose walls changed, and the flow field is rebuilt
+// whenever the player reaches a new tile or the walls change
+void Level::updateNavigation() {
+    PROFILE_SCOPE("Level::updateNavigation");
+
+    if (this->pathfindingMode == PathfindingMode::Hierarchical) {
+        this->hierarchicalMap.update();
+    }
+
+    if (this->pathfindingMode != PathfindingMode::FlowField)
+        return;
+
+    int playerTile = this->player.getTile();
+
+    if (playerTile != this->flowField.getGoal() ||
+        this->map.getChangeCount() != this->flowFieldChangeCount) {
+        this->flowField.rebuild(&this->map, playerTile);
+        this->flowFieldChangeCount = this->map.getChangeCount();
+    }
+}
+
+// Move every follower by one tick. A follower's planning reads only the map,
+// the player and the shared navigation data, and sets only that follower's
+// velocity, so followers plan across the thread pool. Their bodies are then
+// moved together in one pass, in the order they were created, which keeps the
+// result the same however the planning was scheduled
+void Level::updateFollowers() {
+    PROFILE_SCOPE("Level::updateFollowers");
+
+    int count = this->followers.size();
+
+    this->followerBodies.savePreviousPositions();
+
+    if (count >= PARALLEL_MIN_FOLLOWERS) {
+        ThreadPool::getShared()->parallelFor(
+            count, [this](int i) { this->followers[i].plan(); });
+    } else {
+        for (Follower &follower : this->followers) {
+            follower.plan();
         }
     }
 
-    for (Key key : this->keys) {
-        key.update();
+    this->followerBodies.move(&this->map);
+
+    for (int i = 0; i < count; i++) {
+        this->followerHash.move(i, this->followerBodies.getX(i),
+                                this->followerBodies.getY(i));
     }
+}
 
-    this->player.update();
+// Pick up every key the player is touching. Keys don't move, so only the
+// player's position needs checking. Of several keys touched at once, the one
+// earliest in the key storage is taken first, which leaves the other keys in
+// the same order as when every key was checked in turn
+void Level::collectKeys() {
+    PROFILE_SCOPE("Level::collectKeys");
+
+    Vector2f *position = this->player.getPosition();
+    Vector2f *dimensions = this->player.getDimensions();
+
+    // Keys are filed in the key hash by their slot
+    this->nearby.clear();
+    this->keyHash.query(position->x, position->y, dimensions->x, dimensions->y,
+                        &this->nearby);
+
+    auto getIndex = [this](int slot) {
+        return this->keys.getIndex(this->keys.getHandleInSlot(slot));
+    };
+
+    // Taking a key moves the last one into its place, so the earliest is
+    // looked for again after every key taken
+    while (!this->nearby.empty()) {
+        auto first = this->nearby.begin();
+        for (auto it = first + 1; it != this->nearby.end(); it++) {
+            if (getIndex(*it) < getIndex(*first)) {
+                first = it;
+            }
+        }
 
-    this->follower.update();
+        EntityHandle key = this->keys.getHandleInSlot(*first);
+        *first = this->nearby.back();
+        this->nearby.pop_back();
+
+        this->keyHash.remove(key.slot);
+        this->keys.remove(key);
+        this->player.setNumKeys(this->player.getNumKeys() + 1);
+    }
 }
 
-// Update function for the level (calls the render function)
-void Level::update() { this->render(); }
+// Check whether any follower has caught the player
+bool Level::isPlayerCaught() {
+    PROFILE_SCOPE("Level::isPlayerCaught");
+
+    Vector2f *position = this->player.getPosition();
+    Vector2f *dimensions = this->player.getDimensions();
+
+    this->nearby.clear();
+    this->followerHash.query(position->x, position->y, dimensions->x,
+                             dimensions->y, &this->nearby);
+
+    return !this->nearby.empty();
+}
+
+// Advance the level by one simulation tick: move the player and followers,
+// pick up any keys the player reached, and check whether the level is over.
+// Levels that are over no longer change
+void Level::update(const InputState &input) {
+    PROFILE_SCOPE("Level::update");
+
+    if (this->state != LevelState::Playing)
+        return;
+
+    this->player.setInput(input);
+    this->player.update();
+
+    // The flow field has to lead to where the player is now, or followers
+    // would find it out of date on every tick the player changes tile
+    this->updateNavigation();
+
+    this->updateFollowers();
+
+    this->collectKeys();
+
+    this->tickCount++;
+
+    // The level is won once every key is collected, and lost when a follower
+    // catches the player
+    if (this->player.getNumKeys() == this->numKeys) {
+        this->state = LevelState::Won;
+    } else if (this->isPlayerCaught()) {
+        this->state = LevelState::Lost;
+    }
+}
@@ -0,0 +1,155 @@
+// Loads levels on a background thread ahead of time, so that starting a level
+// only has to create its sprites
+
+#include "Game/LevelLoader.hpp"
+#include "Maze/LevelData.hpp"
+#include "Util/Constants.hpp"
+#include "Util/HierarchicalPathfinding.hpp"
+#include "Util/Profiler.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/**
+ * Constructor for an empty PreparedLevel.
+ */
+PreparedLevel::PreparedLevel() : isLoaded(false), isHierarchical(false) {}
+
+/**
+ * Loads a compiled level and builds its navigation data.
+ *
+ * @param filePath The path to the compiled level file.
+ * @return False if the level file could not be loaded, leaving it empty.
+ */
+bool PreparedLevel::load(const char *filePath) {
+    PROFILE_SCOPE("PreparedLevel::load");
+
+    this->isLoaded = this->data.load(filePath);
+
+    // Searching tile by tile gets too expensive on large maps, so plan over
+    // cluster entrances there instead, precomputed once up front. Levels with
+    // several followers share a flow field instead, which needs no graph
+    TileGrid *map = &this->data.map;
+    this->isHierarchical = this->data.followers.size() <= 1 &&
+                           (map->getWidth() >= HIERARCHICAL_MIN_MAP_SIZE ||
+                            map->getHeight() >= HIERARCHICAL_MIN_MAP_SIZE);
+
+    if (this->isHierarchical) {
+        this->hierarchicalMap.build(map, HIERARCHICAL_CLUSTER_SIZE);
+    }
+
+    return this->isLoaded;
+}
+
+/**
+ * Constructor for the LevelLoader class, starting its worker thread.
+ */
+LevelLoader::LevelLoader() : loadingIndex(-1), isStopping(false) {
+    this->worker = std::thread(&LevelLoader::run, this);
+}
+
+/**
+ * Gets the path of a level's compiled file. Levels are compiled from their
+ * text sources by `make levels`.
+ *
+ * @param index The number of the level, starting from 1.
+ * @return The path to the level file.
+ */
+std::string LevelLoader::getLevelPath(int index) {
+    return "res/levels/level" + std::to_string(index) + ".lvl";
+}
+
+/**
+ * Loads the requested levels until the loader is destroyed.
+ */
+void LevelLoader::run() {
+    PROFILE_THREAD_NAME("LevelLoader");
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (true) {
+        this->condition.wait(lock, [this]() {
+            return this->isStopping || !this->requests.empty();
+        });
+
+        if (this->isStopping)
+            return;
+
+        int index = this->requests.front();
+        this->requests.pop_front();
+        this->loadingIndex = index;
+
+        // Load without holding the lock so the game can keep making requests
+        lock.unlock();
+        std::unique_ptr<PreparedLevel> level =
+            std::make_unique<PreparedLevel>();
+        level->load(getLevelPath(index).c_str());
+        lock.lock();
+
+        this->loadingIndex = -1;
+        this->loaded[index] = std::move(level);
+    }
+}
+
+/**
+ * Asks for a level to be loaded in the background. Levels that are already
+ * loaded or on their way are left alone, so it is cheap to call every frame.
+ * The latest request is loaded first.
+ *
+ * @param index The number of the level, starting from 1.
+ */
+void LevelLoader::preload(int index) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->loadingIndex == index || this->loaded.count(index) != 0)
+        return;
+
+    for (auto it = this->requests.begin(); it != this->requests.end(); it++) {
+        if (*it == index) {
+            this->requests.erase(it);
+            break;
+        }
+    }
+
+    this->requests.push_front(index);
+    this->condition.notify_one();
+}
+
+/**
+ * Takes a loaded level without waiting for it. Levels that have not been
+ * loaded yet are requested instead. A level that failed to load is taken like
+ * any other, with isLoaded false, so it is not requested over and over.
+ *
+ * @param index The number of the level, starting from 1.
+ * @return The loaded level, or nullptr if it is not ready yet.
+ */
+std::unique_ptr<PreparedLevel> LevelLoader::take(int index) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        auto it = this->loaded.find(index);
+        if (it != this->loaded.end()) {
+            std::unique_ptr<PreparedLevel> level = std::move(it->second);
+            this->loaded.erase(it);
+            return level;
+        }
+    }
+
+    this->preload(index);
+    return nullptr;
+}
+
+/**
+ * Destructor for the LevelLoader class, stopping its worker thread. A level
+ * being loaded is finished first.
+ */
+LevelLoader::~LevelLoader() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->isStopping = true;
+    }
+
+    this->condition.notify_one();
+    this->worker.join();
+}
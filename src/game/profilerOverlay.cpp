@@ -0,0 +1,86 @@
+// On-screen summary of the frame profiler: how long each profiled scope took
+// on average and at most over the last second. Only exists in builds with
+// PROFILING defined
+
+#include "Game/ProfilerOverlay.hpp"
+
+#ifdef PROFILING
+
+#include "UI/GlyphText.hpp"
+#include "Util/Profiler.hpp"
+#include <cstdio>
+
+// Point size of the overlay font
+const int OVERLAY_FONT_SIZE = 8;
+
+// Pixels between lines of the overlay
+const int OVERLAY_LINE_HEIGHT = OVERLAY_FONT_SIZE + 4;
+
+// Where the first line is drawn, below the HUD
+const int OVERLAY_X = 4;
+const int OVERLAY_Y = 44;
+
+// Most scopes listed at once
+const int OVERLAY_MAX_SCOPES = 24;
+
+// Nanoseconds the scopes are summed up over, and between refreshes of the text
+const int64_t OVERLAY_PERIOD = 1000000000;
+const int64_t OVERLAY_REFRESH_PERIOD = 250000000;
+
+/**
+ * Constructor for the ProfilerOverlay class. The overlay starts out hidden.
+ *
+ * @param window The Window object the overlay is drawn to.
+ */
+ProfilerOverlay::ProfilerOverlay(Window *window)
+    : refreshTime(0), isVisible(false) {
+    this->lines.reserve(OVERLAY_MAX_SCOPES + 1);
+
+    for (int i = 0; i <= OVERLAY_MAX_SCOPES; i++) {
+        this->lines.emplace_back(OVERLAY_FONT_SIZE, OVERLAY_X,
+                                 OVERLAY_Y + i * OVERLAY_LINE_HEIGHT, window);
+    }
+
+    this->lines[0].setText("SCOPE  AVG MS  MAX MS  CALLS/S");
+}
+
+/**
+ * Shows the overlay if it is hidden, and hides it otherwise.
+ */
+void ProfilerOverlay::toggle() { this->isVisible = !this->isVisible; }
+
+/**
+ * Refreshes the summary every so often and draws the overlay if it is
+ * visible. Called once per frame.
+ */
+void ProfilerOverlay::update() {
+    if (!this->isVisible)
+        return;
+
+    int64_t now = Profiler::now();
+
+    if (now - this->refreshTime >= OVERLAY_REFRESH_PERIOD) {
+        this->refreshTime = now;
+        Profiler::getStats(now - OVERLAY_PERIOD, &this->stats);
+
+        char buffer[64];
+        for (int i = 0; i < OVERLAY_MAX_SCOPES; i++) {
+            if (i < (int)this->stats.size()) {
+                const ProfileStats &scope = this->stats[i];
+                snprintf(buffer, sizeof(buffer), "%s  %.3f  %.3f  %d",
+                         scope.name, scope.total / 1e6 / scope.count,
+                         scope.max / 1e6, scope.count);
+            } else {
+                buffer[0] = '\0';
+            }
+
+            this->lines[i + 1].setText(buffer);
+        }
+    }
+
+    for (GlyphText &line : this->lines) {
+        line.update();
+    }
+}
+
+#endif
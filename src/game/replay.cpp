@@ -0,0 +1,295 @@
+// Recording of the input a level was played with, tick by tick. Since levels
+// are deterministic, playing the same input back on the same level reproduces
+// the session exactly, which a checksum of the final state confirms
+
+#include "Game/Replay.hpp"
+#include "Util/Input.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// Identifies a file as a replay
+const char REPLAY_FILE_MAGIC[4] = {'I', 'F', 'R', 'P'};
+
+// Bumped whenever the layout of replay files changes
+const uint16_t REPLAY_FILE_VERSION = 1;
+
+/**
+ * Constructor for an empty Replay with no input.
+ */
+Replay::Replay() : levelIndex(0), seed(0), tickCount(0), checksum(0) {}
+
+/**
+ * Throws away any recorded input and starts recording a new session.
+ *
+ * @param levelIndex The number of the level being played.
+ * @param seed Seed of any randomness in the session.
+ */
+void Replay::start(int levelIndex, uint32_t seed) {
+    this->levelIndex = levelIndex;
+    this->seed = seed;
+    this->runs.clear();
+    this->tickCount = 0;
+    this->checksum = 0;
+}
+
+/**
+ * Records the input of the next tick, extending the last run when the same
+ * buttons are still held.
+ *
+ * @param input The input the tick was played with.
+ */
+void Replay::record(InputState input) {
+    if (!this->runs.empty() &&
+        this->runs.back().input.buttons == input.buttons) {
+        this->runs.back().length++;
+    } else {
+        this->runs.push_back(ReplayRun{input, 1});
+    }
+
+    this->tickCount++;
+}
+
+/**
+ * Finishes the recording with the state the level ended up in.
+ *
+ * @param checksum Level::getChecksum after the last recorded tick.
+ */
+void Replay::finish(uint64_t checksum) { this->checksum = checksum; }
+
+/**
+ * Writes the replay to a file.
+ *
+ * @param filePath The path to write the replay to.
+ * @return False if the file could not be written.
+ */
+bool Replay::save(const char *filePath) const {
+    ReplayFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_FILE_MAGIC, sizeof(REPLAY_FILE_MAGIC));
+    header.version = REPLAY_FILE_VERSION;
+    header.levelIndex = this->levelIndex;
+    header.seed = this->seed;
+    header.tickCount = this->tickCount;
+    header.runCount = this->runs.size();
+    header.checksum = this->checksum;
+
+    // Runs are mostly short, so their lengths are stored 7 bits per byte,
+    // with the top bit set on every byte but the last
+    std::vector<uint8_t> bytes;
+    for (const ReplayRun &run : this->runs) {
+        bytes.push_back(run.input.buttons);
+
+        uint32_t length = run.length;
+        while (length >= 0x80) {
+            bytes.push_back((length & 0x7f) | 0x80);
+            length >>= 7;
+        }
+        bytes.push_back(length);
+    }
+
+    FILE *file = fopen(filePath, "wb");
+    if (file == NULL) {
+        std::cout << "FAILED TO WRITE REPLAY " << filePath << "\n";
+        return false;
+    }
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(bytes.data(), 1, bytes.size(), file);
+
+    bool isWritten = ferror(file) == 0;
+    if (fclose(file) != 0 || !isWritten) {
+        std::cout << "FAILED TO WRITE REPLAY " << filePath << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Reads a replay written by save.
+ *
+ * @param filePath The path to the replay file.
+ * @return False if the file could not be read or is not a valid replay.
+ */
+bool Replay::load(const char *filePath) {
+    FILE *file = fopen(filePath, "rb");
+    if (file == NULL) {
+        std::cout << "FAILED TO OPEN REPLAY " << filePath << "\n";
+        return false;
+    }
+
+    ReplayFileHeader header;
+    std::vector<uint8_t> bytes;
+
+    bool isValid =
+        fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.magic, REPLAY_FILE_MAGIC, sizeof(REPLAY_FILE_MAGIC)) ==
+            0 &&
+        header.version == REPLAY_FILE_VERSION;
+
+    // The runs take up the rest of the file
+    uint8_t buffer[4096];
+    size_t count;
+    while (isValid && (count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    fclose(file);
+
+    std::vector<ReplayRun> runs;
+    size_t position = 0;
+    int tickCount = 0;
+
+    for (uint32_t i = 0; isValid && i < header.runCount; i++) {
+        if (position >= bytes.size()) {
+            isValid = false;
+            break;
+        }
+
+        ReplayRun run;
+        run.input.buttons = bytes[position++];
+
+        uint32_t length = 0;
+        int shift = 0;
+        bool isLastByte = false;
+        while (!isLastByte && position < bytes.size() && shift < 32) {
+            length |= uint32_t(bytes[position] & 0x7f) << shift;
+            isLastByte = (bytes[position++] & 0x80) == 0;
+            shift += 7;
+        }
+
+        run.length = length;
+        isValid = isLastByte && run.length > 0;
+        tickCount += run.length;
+        runs.push_back(run);
+    }
+
+    isValid = isValid && tickCount == (int)header.tickCount;
+
+    if (!isValid) {
+        std::cout << "INVALID REPLAY FILE " << filePath << "\n";
+        return false;
+    }
+
+    this->levelIndex = header.levelIndex;
+    this->seed = header.seed;
+    this->runs = std::move(runs);
+    this->tickCount = tickCount;
+    this->checksum = header.checksum;
+
+    return true;
+}
+
+/**
+ * Checks whether a playback of the replay ended in the same state as the
+ * recording, reporting the result.
+ *
+ * @param checksum Level::getChecksum at the end of the playback.
+ * @param tickCount Number of ticks the playback ran for.
+ * @return True if the playback matched the recording.
+ */
+bool Replay::verify(uint64_t checksum, int tickCount) const {
+    if (checksum != this->checksum || tickCount != this->tickCount) {
+        printf("REPLAY DIVERGED: expected checksum %016llx after %d ticks, "
+               "got %016llx after %d ticks\n",
+               (unsigned long long)this->checksum, this->tickCount,
+               (unsigned long long)checksum, tickCount);
+        return false;
+    }
+
+    printf("replay matched: checksum %016llx after %d ticks\n",
+           (unsigned long long)checksum, tickCount);
+    return true;
+}
+
+/**
+ * Gets the number of the level the replay was recorded on.
+ *
+ * @return The level number, starting from 1.
+ */
+int Replay::getLevelIndex() const { return this->levelIndex; }
+
+/**
+ * Gets the seed of any randomness in the recorded session.
+ *
+ * @return The seed.
+ */
+uint32_t Replay::getSeed() const { return this->seed; }
+
+/**
+ * Gets the number of ticks recorded.
+ *
+ * @return The number of ticks.
+ */
+int Replay::getTickCount() const { return this->tickCount; }
+
+/**
+ * Gets the checksum of the level's state at the end of the recording.
+ *
+ * @return The checksum.
+ */
+uint64_t Replay::getChecksum() const { return this->checksum; }
+
+/**
+ * Gets the number of runs the input is stored in.
+ *
+ * @return The number of runs.
+ */
+int Replay::getRunCount() const { return this->runs.size(); }
+
+/**
+ * Gets a run of recorded input.
+ *
+ * @param index Index of the run, in the order they were recorded.
+ * @return The run.
+ */
+const ReplayRun &Replay::getRun(int index) const { return this->runs[index]; }
+
+/**
+ * Constructor for a ReplayInput with nothing to play back.
+ */
+ReplayInput::ReplayInput() : replay(nullptr), run(0), runTick(0) {}
+
+/**
+ * Starts playing back a replay from its first tick.
+ *
+ * @param replay The replay to play back, which must outlive the playback.
+ */
+void ReplayInput::start(const Replay *replay) {
+    this->replay = replay;
+    this->run = 0;
+    this->runTick = 0;
+}
+
+/**
+ * Checks whether every recorded tick has been played back.
+ *
+ * @return True once the replay has run out of input.
+ */
+bool ReplayInput::isFinished() const {
+    return this->replay == nullptr ||
+           this->run >= this->replay->getRunCount();
+}
+
+/**
+ * Gets the recorded input of the next tick. Nothing is held once the replay
+ * has run out.
+ *
+ * @return The input for this tick.
+ */
+InputState ReplayInput::poll() {
+    if (this->isFinished())
+        return InputState{0};
+
+    const ReplayRun &run = this->replay->getRun(this->run);
+
+    this->runTick++;
+    if (this->runTick == run.length) {
+        this->run++;
+        this->runTick = 0;
+    }
+
+    return run.input;
+}
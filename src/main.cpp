@@ -1,11 +1,40 @@
 // Main program entry point
 #include "Game/Game.hpp"
+#include <cstdlib>
+#include <cstring>
 
 int main(int argc, char **argv) {
+    // Simulate a level without a window, optionally recording the bot:
+    // ItFollows --headless [level] [max ticks] [seed] [replay file]
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0) {
+        int levelIndex = argc > 2 ? atoi(argv[2]) : 1;
+        int maxTicks = argc > 3 ? atoi(argv[3]) : 100000;
+        unsigned int seed = argc > 4 ? strtoul(argv[4], NULL, 10) : 1;
+        const char *recordPath = argc > 5 ? argv[5] : nullptr;
+
+        return Game::runHeadless(levelIndex, maxTicks, seed, recordPath);
+    }
+
+    // Play a replay back without a window as fast as possible:
+    // ItFollows --replay-headless <replay file>
+    if (argc > 2 && strcmp(argv[1], "--replay-headless") == 0) {
+        return Game::runReplay(argv[2]);
+    }
+
     // Create a Game object with the title "It Follows" and a frame rate of 60
     // frames per second
     Game game("It Follows", 60);
 
+    // Record every level played, or watch a replay in real time:
+    // ItFollows --record <replay file>
+    // ItFollows --replay <replay file>
+    if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+        game.setRecordPath(argv[2]);
+    } else if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        if (!game.watchReplay(argv[2]))
+            return 1;
+    }
+
     // Initialize the game instance, setting up necessary components and
     // resources
     game.init();
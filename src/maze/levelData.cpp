@@ -0,0 +1,262 @@
+// Everything needed to build a level: its walls and where the player, keys
+// and followers start. Levels are authored as text and compiled to a binary
+// format that is memory-mapped and copied straight into a TileGrid
+
+#include "Maze/LevelData.hpp"
+#include "Maze/TileGrid.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Identifies a file as a compiled level
+const char LEVEL_FILE_MAGIC[4] = {'I', 'F', 'L', 'V'};
+
+// Bumped whenever the layout of compiled level files changes
+const uint16_t LEVEL_FILE_VERSION = 1;
+
+// Largest number of tiles along either axis a compiled level may have
+const uint32_t LEVEL_FILE_MAX_SIZE = 1 << 16;
+
+// Largest number of tiles a compiled level may have in total. Tiles are
+// indexed with ints everywhere, and pixel coordinates are 16 times larger
+// still, so this stays well clear of overflowing them
+const size_t LEVEL_FILE_MAX_TILES = 1 << 24;
+
+/**
+ * Checks that every spawn in a table is on the map.
+ *
+ * @param map The map the spawns are on.
+ * @param spawns The first spawn of the table.
+ * @param count Number of spawns in the table.
+ * @return False if any spawn is outside of the map.
+ */
+bool areSpawnsInBounds(const TileGrid &map, const LevelSpawn *spawns,
+                       uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (!map.isInBounds(spawns[i].x, spawns[i].y))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Rounds a size in bytes up to the next multiple of 8, keeping the wall bits
+ * that follow the chunk table aligned for 64-bit reads.
+ *
+ * @param size The size to round.
+ * @return The rounded size.
+ */
+size_t alignTo8(size_t size) { return (size + 7) & ~size_t(7); }
+
+/**
+ * Constructor for empty LevelData with no tiles and no player.
+ */
+LevelData::LevelData() : player(LevelSpawn{-1, -1}) {}
+
+/**
+ * Reads a level from its text source. Every non-empty line is a row of tiles
+ * separated by spaces: '1' for walls, 'P', 'K' and 'F' for the player, keys
+ * and followers, and anything else for open space. The map is as wide as its
+ * longest row.
+ *
+ * @param filePath The path to the text file.
+ * @return False if the file could not be opened.
+ */
+bool LevelData::loadText(const char *filePath) {
+    std::ifstream fileStream(filePath);
+
+    if (!fileStream) {
+        std::cout << "FAILED TO OPEN LEVEL " << filePath << "\n";
+        return false;
+    }
+
+    // Read the rows of the file, dropping the spaces between tiles
+    std::vector<std::string> rows;
+    std::string line;
+    int width = 0;
+
+    while (std::getline(fileStream, line)) {
+        std::string row;
+        for (char c : line) {
+            if (c != ' ' && c != '\r')
+                row += c;
+        }
+
+        if (!row.empty()) {
+            width = std::max(width, (int)row.size());
+            rows.push_back(row);
+        }
+    }
+
+    this->map = TileGrid(width, rows.size());
+    this->player = LevelSpawn{-1, -1};
+    this->keys.clear();
+    this->followers.clear();
+
+    for (int row = 0; row < (int)rows.size(); row++) {
+        for (int col = 0; col < (int)rows[row].size(); col++) {
+            switch (rows[row][col]) {
+            case '1':
+                this->map.setWall(col, row, true);
+                break;
+            case 'P':
+                this->player = LevelSpawn{col, row};
+                break;
+            case 'K':
+                this->keys.push_back(LevelSpawn{col, row});
+                break;
+            case 'F':
+                this->followers.push_back(LevelSpawn{col, row});
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Loads a compiled level. The file is memory-mapped and its tables are copied
+ * directly into place, so loading takes time proportional to the number of
+ * wall chunks rather than the number of tiles.
+ *
+ * @param filePath The path to the compiled level file.
+ * @return False if the file could not be read or is not a valid level, such
+ * as one too large to index or with a player, key or follower off the map.
+ */
+bool LevelData::load(const char *filePath) {
+    int file = open(filePath, O_RDONLY);
+    if (file < 0) {
+        std::cout << "FAILED TO OPEN LEVEL " << filePath << "\n";
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 ||
+        fileStat.st_size < (off_t)sizeof(LevelFileHeader)) {
+        std::cout << "FAILED TO READ LEVEL " << filePath << "\n";
+        close(file);
+        return false;
+    }
+
+    size_t size = fileStat.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (mapping == MAP_FAILED) {
+        std::cout << "FAILED TO MAP LEVEL " << filePath << "\n";
+        return false;
+    }
+
+    const unsigned char *bytes = (const unsigned char *)mapping;
+    const LevelFileHeader *header = (const LevelFileHeader *)bytes;
+
+    bool isValid =
+        memcmp(header->magic, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC)) ==
+            0 &&
+        header->version == LEVEL_FILE_VERSION &&
+        header->chunkShift == TileGrid::CHUNK_SHIFT &&
+        header->width <= LEVEL_FILE_MAX_SIZE &&
+        header->height <= LEVEL_FILE_MAX_SIZE &&
+        size_t(header->width) * header->height <= LEVEL_FILE_MAX_TILES;
+
+    // Work out where each table starts, making sure all of them fit
+    size_t keysOffset = sizeof(LevelFileHeader);
+    size_t followersOffset =
+        keysOffset + header->keyCount * sizeof(LevelSpawn);
+    size_t slotsOffset =
+        followersOffset + header->followerCount * sizeof(LevelSpawn);
+
+    TileGrid map(isValid ? header->width : 0, isValid ? header->height : 0);
+    size_t wallsOffset =
+        alignTo8(slotsOffset + map.getChunkTableSize() * sizeof(int32_t));
+    size_t end = wallsOffset + (size_t)header->chunkCount *
+                                   TileGrid::CHUNK_WORDS * sizeof(uint64_t);
+
+    isValid = isValid && end <= size &&
+              map.assignChunks((const int32_t *)(bytes + slotsOffset),
+                               (const uint64_t *)(bytes + wallsOffset),
+                               header->chunkCount);
+
+    const LevelSpawn *keys = (const LevelSpawn *)(bytes + keysOffset);
+    const LevelSpawn *followers = (const LevelSpawn *)(bytes + followersOffset);
+
+    // Every entity must start on the map
+    isValid = isValid && map.isInBounds(header->playerX, header->playerY) &&
+              areSpawnsInBounds(map, keys, header->keyCount) &&
+              areSpawnsInBounds(map, followers, header->followerCount);
+
+    if (isValid) {
+        this->map = std::move(map);
+        this->player = LevelSpawn{header->playerX, header->playerY};
+        this->keys.assign(keys, keys + header->keyCount);
+        this->followers.assign(followers, followers + header->followerCount);
+    } else {
+        std::cout << "INVALID LEVEL FILE " << filePath << "\n";
+    }
+
+    munmap(mapping, size);
+
+    return isValid;
+}
+
+/**
+ * Writes the level in the compiled format read by load.
+ *
+ * @param filePath The path to write the compiled level to.
+ * @return False if the file could not be written.
+ */
+bool LevelData::save(const char *filePath) const {
+    LevelFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC));
+    header.version = LEVEL_FILE_VERSION;
+    header.chunkShift = TileGrid::CHUNK_SHIFT;
+    header.width = this->map.getWidth();
+    header.height = this->map.getHeight();
+    header.playerX = this->player.x;
+    header.playerY = this->player.y;
+    header.keyCount = this->keys.size();
+    header.followerCount = this->followers.size();
+    header.chunkCount = this->map.getAllocatedChunkCount();
+
+    FILE *file = fopen(filePath, "wb");
+    if (file == NULL) {
+        std::cout << "FAILED TO WRITE LEVEL " << filePath << "\n";
+        return false;
+    }
+
+    size_t slotsSize = this->map.getChunkTableSize() * sizeof(int32_t);
+    size_t slotsEnd = sizeof(header) +
+                      (this->keys.size() + this->followers.size()) *
+                          sizeof(LevelSpawn) +
+                      slotsSize;
+    const uint64_t padding = 0;
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(this->keys.data(), sizeof(LevelSpawn), this->keys.size(), file);
+    fwrite(this->followers.data(), sizeof(LevelSpawn), this->followers.size(),
+           file);
+    fwrite(this->map.getChunkSlots(), 1, slotsSize, file);
+    fwrite(&padding, 1, alignTo8(slotsEnd) - slotsEnd, file);
+    fwrite(this->map.getChunkWalls(), sizeof(uint64_t) * TileGrid::CHUNK_WORDS,
+           header.chunkCount, file);
+
+    bool isWritten = ferror(file) == 0;
+    if (fclose(file) != 0 || !isWritten) {
+        std::cout << "FAILED TO WRITE LEVEL " << filePath << "\n";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,159 @@
+// Compact grid recording which tiles of the map are walls. The grid is split
+// into square chunks, and chunks without any walls take up no memory
+
+#include "Maze/TileGrid.hpp"
+#include <algorithm>
+
+// Direction vectors for the four tiles adjacent to a given tile
+const int neighborXDirections[] = {0, 0, -1, 1};
+const int neighborYDirections[] = {-1, 1, 0, 0};
+
+/**
+ * Constructor for an empty TileGrid with no tiles.
+ */
+TileGrid::TileGrid() : width(0), height(0), chunksX(0), chunksY(0) {}
+
+/**
+ * Constructor for a TileGrid where every tile starts out open. No chunk is
+ * allocated until a wall is placed in it.
+ *
+ * @param width Number of tiles along the x-axis.
+ * @param height Number of tiles along the y-axis.
+ * @param arena Arena to allocate the grid's tables from, or nullptr to use the
+ * heap.
+ */
+TileGrid::TileGrid(int width, int height, Arena *arena)
+    : width(width), height(height),
+      chunksX((width + CHUNK_SIZE - 1) >> CHUNK_SHIFT),
+      chunksY((height + CHUNK_SIZE - 1) >> CHUNK_SHIFT),
+      chunkSlots(chunksX * chunksY, -1, ArenaAllocator<int>(arena)),
+      chunkWalls(ArenaAllocator<uint64_t>(arena)),
+      changes(ArenaAllocator<int>(arena)) {}
+
+/**
+ * Constructor copying another TileGrid's walls and changes into an arena.
+ * Copying takes time proportional to the number of wall chunks.
+ *
+ * @param other The grid to copy.
+ * @param arena Arena to allocate the copy's tables from.
+ */
+TileGrid::TileGrid(const TileGrid &other, Arena *arena)
+    : width(other.width), height(other.height), chunksX(other.chunksX),
+      chunksY(other.chunksY),
+      chunkSlots(other.chunkSlots, ArenaAllocator<int>(arena)),
+      chunkWalls(other.chunkWalls, ArenaAllocator<uint64_t>(arena)),
+      changes(other.changes, ArenaAllocator<int>(arena)) {}
+
+/**
+ * Marks a tile as a wall or as open space.
+ *
+ * @param x The x tile coordinate.
+ * @param y The y tile coordinate.
+ * @param isWall Whether the tile should be a wall.
+ */
+void TileGrid::setWall(int x, int y, bool isWall) {
+    if (!this->isInBounds(x, y))
+        return;
+
+    int &slot = this->chunkSlots[(y >> CHUNK_SHIFT) * this->chunksX +
+                                 (x >> CHUNK_SHIFT)];
+
+    // Open tiles in a chunk without walls are already open
+    if (slot < 0) {
+        if (!isWall)
+            return;
+
+        slot = this->chunkWalls.size() / CHUNK_WORDS;
+        this->chunkWalls.resize(this->chunkWalls.size() + CHUNK_WORDS, 0);
+    }
+
+    int bit = (y & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (x & (CHUNK_SIZE - 1));
+    uint64_t &word = this->chunkWalls[slot * CHUNK_WORDS + (bit >> 6)];
+
+    if (isWall) {
+        word |= uint64_t(1) << (bit & 63);
+    } else {
+        word &= ~(uint64_t(1) << (bit & 63));
+    }
+}
+
+/**
+ * Changes a tile while the level is being played. Unlike setWall, which is
+ * meant for building the grid, the change is recorded so that anything derived
+ * from the grid can update itself.
+ *
+ * @param x The x tile coordinate.
+ * @param y The y tile coordinate.
+ * @param isWall Whether the tile should be a wall.
+ */
+void TileGrid::changeWall(int x, int y, bool isWall) {
+    if (!this->isInBounds(x, y) || this->isWall(x, y) == isWall)
+        return;
+
+    this->setWall(x, y, isWall);
+    this->changes.push_back(this->toIndex(x, y));
+}
+
+/**
+ * Gets the number of chunks that hold at least one wall, or did at some point.
+ *
+ * @return The number of allocated chunks.
+ */
+int TileGrid::getAllocatedChunkCount() const {
+    return this->chunkWalls.size() / CHUNK_WORDS;
+}
+
+/**
+ * Replaces every wall of the grid with chunks copied from elsewhere, such as
+ * a compiled level file. The slot table has one entry per chunk of the grid,
+ * laid out like the grid's own (see getChunkSlots).
+ *
+ * @param slots Position of each chunk's bits within walls, or -1 if empty.
+ * @param walls Wall bits of every allocated chunk, CHUNK_WORDS per chunk.
+ * @param chunkCount Number of chunks stored in walls.
+ * @return False if a slot points outside of walls, leaving the grid empty.
+ */
+bool TileGrid::assignChunks(const int32_t *slots, const uint64_t *walls,
+                            int chunkCount) {
+    for (int i = 0; i < (int)this->chunkSlots.size(); i++) {
+        if (slots[i] < -1 || slots[i] >= chunkCount) {
+            std::fill(this->chunkSlots.begin(), this->chunkSlots.end(), -1);
+            this->chunkWalls.clear();
+            return false;
+        }
+    }
+
+    this->chunkSlots.assign(slots, slots + this->chunkSlots.size());
+    this->chunkWalls.assign(walls, walls + chunkCount * CHUNK_WORDS);
+
+    return true;
+}
+
+/**
+ * Finds an open tile to stand in for (x, y). Entities positioned near a wall
+ * can round onto it, in which case one of its open neighbours is used instead.
+ *
+ * @param x The x tile coordinate.
+ * @param y The y tile coordinate.
+ * @return The index of (x, y) if it is open, otherwise the index of an open
+ * adjacent tile, or -1 if there is none.
+ */
+int TileGrid::findOpenNeighbor(int x, int y) const {
+    if (!this->isWall(x, y))
+        return this->toIndex(x, y);
+
+    int openIndex = -1;
+
+    // Search adjacent cells
+    for (int i = 0; i < 4; i++) {
+        // Move one space either up, down, left, or right
+        int newX = x + neighborXDirections[i];
+        int newY = y + neighborYDirections[i];
+
+        if (!this->isWall(newX, newY)) {
+            openIndex = this->toIndex(newX, newY);
+        }
+    }
+
+    return openIndex;
+}
@@ -0,0 +1,207 @@
+// Walls and floor of a level, pre-rendered into cached textures. The map is
+// split into square blocks of tiles, each rendered once into a texture of its
+// own when it first comes into view and then drawn with a single copy. Only
+// the tiles that change are drawn again
+
+#include "Maze/TileLayer.hpp"
+#include "Maze/TileGrid.hpp"
+#include "Util/Constants.hpp"
+#include "Util/Window.hpp"
+#include <algorithm>
+#include <iostream>
+
+/**
+ * Constructor for the TileLayer class. Nothing is rendered until the layer
+ * is first drawn.
+ *
+ * @param map The grid of walls to draw.
+ * @param window The Window object the layer is drawn to.
+ */
+TileLayer::TileLayer(TileGrid *map, Window *window)
+    : map(map), window(window),
+      wallSprite(window->loadSprite("res/img/MapWall16.png")),
+      floorSprite(window->loadSprite("res/img/MapGridCell.png")),
+      blocksX((map->getWidth() + BLOCK_SIZE - 1) / BLOCK_SIZE),
+      blocksY((map->getHeight() + BLOCK_SIZE - 1) / BLOCK_SIZE),
+      textures(blocksX * blocksY, nullptr), lastUsed(blocksX * blocksY, 0),
+      textureCount(0), frame(0), changeCursor(map->getChangeCount()),
+      canCache(true) {}
+
+/**
+ * Draws a rectangle of tiles to the current render target.
+ *
+ * @param startX The x tile coordinate of the first column to draw.
+ * @param startY The y tile coordinate of the first row to draw.
+ * @param endX The x tile coordinate one past the last column to draw.
+ * @param endY The y tile coordinate one past the last row to draw.
+ * @param offsetX Pixels subtracted from the x-coordinate of every tile.
+ * @param offsetY Pixels subtracted from the y-coordinate of every tile.
+ */
+void TileLayer::drawTiles(int startX, int startY, int endX, int endY,
+                          int offsetX, int offsetY) {
+    SDL_Renderer *renderer = this->window->getRenderer();
+
+    for (int y = startY; y < endY; y++) {
+        for (int x = startX; x < endX; x++) {
+            const TextureRegion &sprite =
+                this->map->isWall(x, y) ? this->wallSprite : this->floorSprite;
+
+            SDL_Rect src = {sprite.rect.x, sprite.rect.y, TILE_SIZE,
+                            TILE_SIZE};
+            SDL_Rect dst = {x * TILE_SIZE - offsetX, y * TILE_SIZE - offsetY,
+                            TILE_SIZE, TILE_SIZE};
+            SDL_RenderCopy(renderer, sprite.texture, &src, &dst);
+        }
+    }
+}
+
+/**
+ * Renders every tile of a block into a new texture.
+ *
+ * @param block The index of the block, row by row.
+ * @return The rendered texture, or nullptr if it could not be created.
+ */
+SDL_Texture *TileLayer::renderBlock(int block) {
+    if (this->textureCount >= MAX_BLOCKS) {
+        this->freeOldestBlock();
+    }
+
+    int startX = (block % this->blocksX) * BLOCK_SIZE;
+    int startY = (block / this->blocksX) * BLOCK_SIZE;
+    int endX = std::min(startX + BLOCK_SIZE, this->map->getWidth());
+    int endY = std::min(startY + BLOCK_SIZE, this->map->getHeight());
+
+    SDL_Renderer *renderer = this->window->getRenderer();
+    SDL_Texture *texture = SDL_CreateTexture(
+        renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+        (endX - startX) * TILE_SIZE, (endY - startY) * TILE_SIZE);
+
+    // Without render targets the tiles are drawn directly from then on
+    if (texture == NULL) {
+        std::cout << "FAILED TO CREATE TILE LAYER. SDL_ERROR: "
+                  << SDL_GetError() << "\n";
+        this->canCache = false;
+        return nullptr;
+    }
+
+    SDL_SetRenderTarget(renderer, texture);
+    this->drawTiles(startX, startY, endX, endY, startX * TILE_SIZE,
+                    startY * TILE_SIZE);
+    SDL_SetRenderTarget(renderer, NULL);
+
+    this->textures[block] = texture;
+    this->textureCount++;
+
+    return texture;
+}
+
+/**
+ * Frees the rendered block that has gone the longest without being drawn.
+ */
+void TileLayer::freeOldestBlock() {
+    int oldest = -1;
+
+    for (int i = 0; i < (int)this->textures.size(); i++) {
+        if (this->textures[i] != nullptr &&
+            (oldest == -1 || this->lastUsed[i] < this->lastUsed[oldest])) {
+            oldest = i;
+        }
+    }
+
+    if (oldest != -1) {
+        SDL_DestroyTexture(this->textures[oldest]);
+        this->textures[oldest] = nullptr;
+        this->textureCount--;
+    }
+}
+
+/**
+ * Draws the tiles changed since the last frame into the blocks holding them.
+ * Blocks that are not rendered pick up the changes when they next are.
+ */
+void TileLayer::applyChanges() {
+    int changeCount = this->map->getChangeCount();
+    if (this->changeCursor == changeCount)
+        return;
+
+    SDL_Renderer *renderer = this->window->getRenderer();
+
+    for (; this->changeCursor < changeCount; this->changeCursor++) {
+        int tile = this->map->getChange(this->changeCursor);
+        int x = tile % this->map->getWidth();
+        int y = tile / this->map->getWidth();
+        int block = (y / BLOCK_SIZE) * this->blocksX + x / BLOCK_SIZE;
+
+        if (this->textures[block] == nullptr)
+            continue;
+
+        int blockPixels = BLOCK_SIZE * TILE_SIZE;
+        SDL_SetRenderTarget(renderer, this->textures[block]);
+        this->drawTiles(x, y, x + 1, y + 1, (x / BLOCK_SIZE) * blockPixels,
+                        (y / BLOCK_SIZE) * blockPixels);
+    }
+
+    SDL_SetRenderTarget(renderer, NULL);
+}
+
+/**
+ * Draws the blocks in view of the camera, rendering any that are not cached.
+ * If blocks cannot be cached, their tiles are drawn one by one instead.
+ */
+void TileLayer::render() {
+    this->frame++;
+    this->applyChanges();
+
+    SDL_Renderer *renderer = this->window->getRenderer();
+    SDL_Point camera = this->window->getCamera();
+    int blockPixels = BLOCK_SIZE * TILE_SIZE;
+
+    int startX = std::max(0, camera.x / blockPixels);
+    int startY = std::max(0, camera.y / blockPixels);
+    int endX =
+        std::min(this->blocksX,
+                 (camera.x + this->window->getWidth() - 1) / blockPixels + 1);
+    int endY =
+        std::min(this->blocksY,
+                 (camera.y + this->window->getHeight() - 1) / blockPixels + 1);
+
+    for (int blockY = startY; blockY < endY; blockY++) {
+        for (int blockX = startX; blockX < endX; blockX++) {
+            int block = blockY * this->blocksX + blockX;
+            this->lastUsed[block] = this->frame;
+
+            SDL_Texture *texture = this->textures[block];
+            if (texture == nullptr && this->canCache) {
+                texture = this->renderBlock(block);
+            }
+
+            int tileX = blockX * BLOCK_SIZE;
+            int tileY = blockY * BLOCK_SIZE;
+            int tileEndX = std::min(tileX + BLOCK_SIZE, this->map->getWidth());
+            int tileEndY = std::min(tileY + BLOCK_SIZE, this->map->getHeight());
+
+            if (texture == nullptr) {
+                this->drawTiles(tileX, tileY, tileEndX, tileEndY, camera.x,
+                                camera.y);
+                continue;
+            }
+
+            SDL_Rect dst = {tileX * TILE_SIZE - camera.x,
+                            tileY * TILE_SIZE - camera.y,
+                            (tileEndX - tileX) * TILE_SIZE,
+                            (tileEndY - tileY) * TILE_SIZE};
+            SDL_RenderCopy(renderer, texture, NULL, &dst);
+        }
+    }
+}
+
+/**
+ * Destructor for the TileLayer class, freeing every rendered block.
+ */
+TileLayer::~TileLayer() {
+    for (SDL_Texture *texture : this->textures) {
+        if (texture != nullptr) {
+            SDL_DestroyTexture(texture);
+        }
+    }
+}
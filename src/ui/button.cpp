@@ -22,11 +22,16 @@
 Button::Button(std::string text, int fontSize, float posX, float posY,
                float width, float height, std::function<void()> onClick,
                Window *window)
-    : Sprite(posX, posY, width, height, nullptr, window), text(text),
-      font(nullptr), onClick(onClick) {
-    // Open the specified font file and set font size
-    this->font = TTF_OpenFont("res/fonts/PressStart2P-Regular.ttf", fontSize);
-}
+    : Sprite(posX, posY, width, height, nullptr, window),
+      text(text, fontSize, SDL_Color{255, 255, 255, 255}), onClick(onClick) {}
+
+/**
+ * Changes the text displayed on the button. The text is rasterized again only
+ * if it differs.
+ *
+ * @param text The new string content of the button.
+ */
+void Button::setText(const std::string &text) { this->text.setText(text); }
 
 /**
  * Renders the button on the associated window's renderer.
@@ -42,19 +47,11 @@ void Button::render() {
     SDL_RenderFillRect(renderer, &backgroundRect);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black color
 
-    // Render text
-    SDL_Color White = {255, 255, 255};
-    SDL_Surface *surfaceMessage =
-        TTF_RenderText_Solid(this->font, this->text.c_str(), White);
-
-    SDL_Texture *Message =
-        SDL_CreateTextureFromSurface(renderer, surfaceMessage);
-
     SDL_Rect Message_rect; // create a rect
 
-    // Dynamically calculate the width and height of the rect based on the text
-    // size
-    SDL_QueryTexture(Message, NULL, NULL, &Message_rect.w, &Message_rect.h);
+    // Get the rasterized text along with its size, rebuilt only if changed
+    SDL_Texture *Message =
+        this->text.getTexture(renderer, &Message_rect.w, &Message_rect.h);
 
     // Calculate the centered position for the text
     Message_rect.x =
@@ -63,10 +60,16 @@ void Button::render() {
         this->position.y + (this->dimensions.y - Message_rect.h) / 2;
 
     SDL_RenderCopy(renderer, Message, NULL, &Message_rect);
+}
 
-    // Free the surface and texture
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(Message);
+/**
+ * Sets a function to call every frame the mouse is over the button, such as
+ * to prepare whatever clicking it leads to.
+ *
+ * @param onHover The callback function to be executed while hovered.
+ */
+void Button::setOnHover(std::function<void()> onHover) {
+    this->onHover = onHover;
 }
 
 /**
@@ -82,6 +85,10 @@ void Button::update() {
     int mouseX, mouseY;
     Uint32 mouseState = SDL_GetMouseState(&mouseX, &mouseY);
 
+    if (this->onHover && this->isCollidingWith(mouseX, mouseY, 5, 5)) {
+        this->onHover();
+    }
+
     if (!(mouseState & SDL_BUTTON(SDL_BUTTON_LEFT))) {
         // Left mouse button is not pressed, reset the flag
         buttonClicked = false;
@@ -0,0 +1,97 @@
+// Text laid out glyph by glyph from a glyph atlas and drawn through the sprite
+// batch. Suited to strings that change every frame, such as the HUD, since
+// changing the text never rasterizes anything
+
+#include "UI/GlyphText.hpp"
+#include "Util/Constants.hpp"
+#include "Util/GlyphAtlas.hpp"
+
+// Room reserved for the text up front so that setting it does not allocate
+const int GLYPH_TEXT_CAPACITY = 64;
+
+/**
+ * Constructor for the GlyphText class. The text starts out empty.
+ *
+ * @param fontSize The font size for drawing the text.
+ * @param posX The x-coordinate of the top-left corner of the text.
+ * @param posY The y-coordinate of the top-left corner of the text.
+ * @param window The Window object associated with the text.
+ */
+GlyphText::GlyphText(int fontSize, float posX, float posY, Window *window)
+    : Sprite(posX, posY, 0, 0, nullptr, window), fontSize(fontSize),
+      atlas(nullptr) {
+    this->text.reserve(GLYPH_TEXT_CAPACITY);
+    this->layer = HUD_LAYER;
+}
+
+/**
+ * Gets the glyph atlas for the text's font size, building it if needed.
+ *
+ * @return The glyph atlas.
+ */
+GlyphAtlas *GlyphText::getAtlas() {
+    if (this->atlas == nullptr) {
+        this->atlas = this->window->getGlyphAtlas(this->fontSize);
+    }
+
+    return this->atlas;
+}
+
+/**
+ * Changes the text content. Strings that fit in the reserved capacity are
+ * copied without allocating.
+ *
+ * @param text The new string content of the text.
+ */
+void GlyphText::setText(const char *text) { this->text.assign(text); }
+
+/**
+ * Measures how wide the text is when drawn.
+ *
+ * @return The width of the text in pixels.
+ */
+int GlyphText::getTextWidth() {
+    GlyphAtlas *atlas = this->getAtlas();
+    int width = 0;
+
+    for (char c : this->text) {
+        const GlyphAtlas::Glyph *glyph = atlas->getGlyph(c);
+        if (glyph != nullptr) {
+            width += glyph->advance;
+        }
+    }
+
+    return width;
+}
+
+/**
+ * Queues a quad for every glyph of the text in the window's sprite batch. The
+ * text is positioned on the screen, ignoring the camera.
+ */
+void GlyphText::render() {
+    GlyphAtlas *atlas = this->getAtlas();
+    if (!atlas->isBuilt())
+        return;
+
+    SpriteBatch *batch = this->window->getSpriteBatch();
+    int penX = this->position.x;
+    int penY = this->position.y;
+
+    for (char c : this->text) {
+        const GlyphAtlas::Glyph *glyph = atlas->getGlyph(c);
+        if (glyph == nullptr)
+            continue;
+
+        if (glyph->rect.w > 0) {
+            SDL_Rect dst = {penX, penY, glyph->rect.w, glyph->rect.h};
+            batch->draw(atlas->getTexture(), glyph->rect, dst, this->layer);
+        }
+
+        penX += glyph->advance;
+    }
+}
+
+/**
+ * Updates the text by drawing it.
+ */
+void GlyphText::update() { this->render(); }
@@ -0,0 +1,145 @@
+// A string rasterized into a texture. The texture is kept between frames and
+// only rebuilt when the string, font size or color changes
+
+#include "UI/RenderedText.hpp"
+#include "Util/Constants.hpp"
+#include "Util/FontCache.hpp"
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+
+/**
+ * Constructor for the RenderedText class. Nothing is rasterized until the
+ * texture is first asked for.
+ *
+ * @param text The string to draw.
+ * @param fontSize The point size of the font to draw it in.
+ * @param color The color to draw it in.
+ */
+RenderedText::RenderedText(const std::string &text, int fontSize,
+                           SDL_Color color)
+    : text(text), fontSize(fontSize), color(color), texture(NULL), width(0),
+      height(0), isDirty(true) {}
+
+/**
+ * Copy constructor. The copy rasterizes its own texture when it needs one.
+ *
+ * @param other The text to copy.
+ */
+RenderedText::RenderedText(const RenderedText &other)
+    : RenderedText(other.text, other.fontSize, other.color) {}
+
+/**
+ * Copy assignment. The texture is rasterized again when it is next needed.
+ *
+ * @param other The text to copy.
+ * @return This text.
+ */
+RenderedText &RenderedText::operator=(const RenderedText &other) {
+    if (this != &other) {
+        this->text = other.text;
+        this->fontSize = other.fontSize;
+        this->color = other.color;
+        this->isDirty = true;
+    }
+
+    return *this;
+}
+
+/**
+ * Rasterizes the string into a new texture, replacing the old one.
+ *
+ * @param renderer The renderer to create the texture with.
+ */
+void RenderedText::build(SDL_Renderer *renderer) {
+    if (this->texture != NULL) {
+        SDL_DestroyTexture(this->texture);
+        this->texture = NULL;
+    }
+
+    this->width = 0;
+    this->height = 0;
+    this->isDirty = false;
+
+    TTF_Font *font = FontCache::getFont(FONT_PATH, this->fontSize);
+    if (font == NULL || this->text.empty())
+        return;
+
+    SDL_Surface *surface =
+        TTF_RenderText_Solid(font, this->text.c_str(), this->color);
+    if (surface == NULL) {
+        std::cout << "FAILED TO RENDER TEXT. SDL_ERROR: " << SDL_GetError()
+                  << "\n";
+        return;
+    }
+
+    this->texture = SDL_CreateTextureFromSurface(renderer, surface);
+    this->width = surface->w;
+    this->height = surface->h;
+    SDL_FreeSurface(surface);
+}
+
+/**
+ * Changes the string, rebuilding the texture if it differs.
+ *
+ * @param text The new string.
+ */
+void RenderedText::setText(const std::string &text) {
+    if (text != this->text) {
+        this->text = text;
+        this->isDirty = true;
+    }
+}
+
+/**
+ * Changes the font size, rebuilding the texture if it differs.
+ *
+ * @param fontSize The new point size.
+ */
+void RenderedText::setFontSize(int fontSize) {
+    if (fontSize != this->fontSize) {
+        this->fontSize = fontSize;
+        this->isDirty = true;
+    }
+}
+
+/**
+ * Changes the color, rebuilding the texture if it differs.
+ *
+ * @param color The new color.
+ */
+void RenderedText::setColor(SDL_Color color) {
+    if (color.r != this->color.r || color.g != this->color.g ||
+        color.b != this->color.b || color.a != this->color.a) {
+        this->color = color;
+        this->isDirty = true;
+    }
+}
+
+/**
+ * Gets the rasterized string, building it first if anything changed.
+ *
+ * @param renderer The renderer to create the texture with.
+ * @param width Set to the width of the texture.
+ * @param height Set to the height of the texture.
+ * @return The texture, or NULL if there is nothing to draw.
+ */
+SDL_Texture *RenderedText::getTexture(SDL_Renderer *renderer, int *width,
+                                      int *height) {
+    if (this->isDirty) {
+        this->build(renderer);
+    }
+
+    *width = this->width;
+    *height = this->height;
+
+    return this->texture;
+}
+
+/**
+ * Destructor for the RenderedText class, freeing the texture.
+ */
+RenderedText::~RenderedText() {
+    if (this->texture != NULL) {
+        SDL_DestroyTexture(this->texture);
+    }
+}
@@ -1,6 +1,7 @@
 // Sprite class representing everything that is rendered to the screen
 
 #include "UI/Sprite.hpp"
+#include <cmath>
 
 /**
  * Constructor for the Sprite class.
@@ -22,35 +23,73 @@ Sprite::Sprite(float posX, float posY, float width, float height,
     currentFrame.y = 0;
     currentFrame.w = 16;
     currentFrame.h = 16;
+
+    frameOffset.x = 0;
+    frameOffset.y = 0;
+
+    layer = 0;
 }
 
 /**
- * Renders the sprite on the associated window's renderer.
+ * Sets the texture of the sprite to a region of a (possibly shared) texture.
+ * Frames are then selected relative to the top-left corner of that region.
+ *
+ * @param region The texture and the rectangle within it holding the sprite.
  */
-void Sprite::render() {
-    // Get the SDL renderer from the associated window
-    SDL_Renderer *renderer = this->window->getRenderer();
+void Sprite::setTextureRegion(TextureRegion region) {
+    this->texture = region.texture;
+    this->frameOffset.x = region.rect.x;
+    this->frameOffset.y = region.rect.y;
+}
+
+/**
+ * Sets the texture of the sprite to one of the window's in-game sprites.
+ * Sprites without a window, such as in a headless simulation, are left
+ * without a texture.
+ *
+ * @param filePath The path to the sprite's image file.
+ */
+void Sprite::setSprite(const char *filePath) {
+    if (this->window != nullptr) {
+        this->setTextureRegion(this->window->loadSprite(filePath));
+    }
+}
 
+/**
+ * Gets the position the sprite is drawn at. Sprites that move between
+ * simulation ticks draw somewhere between their last two positions.
+ *
+ * @return The position to draw the sprite at.
+ */
+Vector2f Sprite::getRenderPosition() { return this->position; }
+
+/**
+ * Renders the sprite through the associated window's sprite batch. It is
+ * drawn when the window is next displayed.
+ */
+void Sprite::render() {
     // Set up source and destination rectangles for rendering
 
     // src: holds the position and dimensions of the texture within the texture
     // file
     SDL_Rect src;
-    src.x = this->currentFrame.x;
-    src.y = this->currentFrame.y;
+    src.x = this->frameOffset.x + this->currentFrame.x;
+    src.y = this->frameOffset.y + this->currentFrame.y;
     src.w = this->currentFrame.w;
     src.h = this->currentFrame.h;
 
     // dst: holds the position and dimensions where the texture will be rendered
-    // on the screen
+    // on the screen, relative to the camera
+    SDL_Point camera = this->window->getCamera();
+    Vector2f renderPosition = this->getRenderPosition();
     SDL_Rect dst;
-    dst.x = this->position.x;
-    dst.y = this->position.y;
+    dst.x = round(renderPosition.x) - camera.x;
+    dst.y = round(renderPosition.y) - camera.y;
     dst.w = this->dimensions.x;
     dst.h = this->dimensions.y;
 
-    // Copy the texture to the renderer with the specified rectangles
-    SDL_RenderCopy(renderer, this->texture, &src, &dst);
+    // Queue the texture to be drawn with the specified rectangles
+    this->window->getSpriteBatch()->draw(this->texture, src, dst, this->layer);
 }
 
 /**
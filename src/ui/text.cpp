@@ -13,10 +13,29 @@
  */
 Text::Text(std::string text, int fontSize, float posX, float posY,
            Window *window)
-    : Sprite(posX, posY, 0, 0, nullptr, window), text(text), font(nullptr) {
-    // Open the specified font file and set font size
-    this->font = TTF_OpenFont("res/fonts/PressStart2P-Regular.ttf", fontSize);
-}
+    : Sprite(posX, posY, 0, 0, nullptr, window),
+      text(text, fontSize, SDL_Color{255, 255, 255, 255}) {}
+
+/**
+ * Changes the text content. The text is rasterized again only if it differs.
+ *
+ * @param text The new string content of the text.
+ */
+void Text::setText(const std::string &text) { this->text.setText(text); }
+
+/**
+ * Changes the font size of the text.
+ *
+ * @param fontSize The new font size for rendering the text.
+ */
+void Text::setFontSize(int fontSize) { this->text.setFontSize(fontSize); }
+
+/**
+ * Changes the color of the text.
+ *
+ * @param color The new color for rendering the text.
+ */
+void Text::setColor(SDL_Color color) { this->text.setColor(color); }
 
 /**
  * Renders the text on the associated window's renderer.
@@ -24,20 +43,12 @@ Text::Text(std::string text, int fontSize, float posX, float posY,
 void Text::render() {
     SDL_Renderer *renderer = this->window->getRenderer();
 
-    // Render text
-    SDL_Color White = {255, 255, 255};
-    SDL_Surface *surfaceMessage =
-        TTF_RenderText_Solid(this->font, this->text.c_str(), White);
-
-    SDL_Texture *Message =
-        SDL_CreateTextureFromSurface(renderer, surfaceMessage);
-
     SDL_Rect Message_rect; // Create a rect to hold the text's dimensions and
                            // position for the renderer
 
-    // Dynamically calculate the width and height of the rect based on the text
-    // size
-    SDL_QueryTexture(Message, NULL, NULL, &Message_rect.w, &Message_rect.h);
+    // Get the rasterized text along with its size, rebuilt only if changed
+    SDL_Texture *Message =
+        this->text.getTexture(renderer, &Message_rect.w, &Message_rect.h);
 
     // Calculate the centered position for the text
     Message_rect.x =
@@ -46,10 +57,6 @@ void Text::render() {
         this->position.y + (this->dimensions.y - Message_rect.h) / 2;
 
     SDL_RenderCopy(renderer, Message, NULL, &Message_rect);
-
-    // Free the surface and texture
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(Message);
 }
 
 /**
@@ -0,0 +1,115 @@
+// Monotonic memory arena for objects that all live exactly as long as one
+// another, such as everything belonging to a level. Allocating bumps a pointer,
+// nothing is freed individually, and the whole arena is emptied at once.
+// Several threads may allocate from an arena at once, as followers planning in
+// parallel do when their search arrays grow
+
+#include "Util/Arena.hpp"
+#include <algorithm>
+#include <mutex>
+#include <new>
+
+/**
+ * Constructor for an empty Arena. No memory is allocated until it is first
+ * needed.
+ */
+Arena::Arena() : used(0), previousBlocksUsed(0) {}
+
+/**
+ * Destructor for the Arena class, giving every block back to the heap.
+ */
+Arena::~Arena() {
+    for (Block &block : this->blocks) {
+        ::operator delete(block.memory);
+    }
+}
+
+/**
+ * Starts a new block to allocate from, large enough for at least one
+ * allocation of the given size.
+ *
+ * @param minimumSize Number of bytes the block must be able to hold.
+ */
+void Arena::addBlock(size_t minimumSize) {
+    if (!this->blocks.empty()) {
+        this->previousBlocksUsed += this->blocks.back().size;
+    }
+
+    size_t size = std::max(minimumSize, BLOCK_SIZE);
+    this->blocks.push_back(Block{(char *)::operator new(size), size});
+    this->used = 0;
+}
+
+/**
+ * Hands out memory from the arena. It stays valid until the arena is reset or
+ * destroyed. Safe to call from several threads at once.
+ *
+ * @param size Number of bytes needed.
+ * @param alignment Alignment of the memory, which must be a power of two no
+ * larger than the heap's own alignment.
+ * @return The allocated memory.
+ */
+void *Arena::allocate(size_t size, size_t alignment) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (!this->blocks.empty()) {
+        Block &block = this->blocks.back();
+        size_t start = (this->used + alignment - 1) & ~(alignment - 1);
+
+        if (start + size <= block.size) {
+            this->used = start + size;
+            return block.memory + start;
+        }
+    }
+
+    // New blocks start out aligned for anything the heap can hold
+    this->addBlock(size);
+    this->used = size;
+
+    return this->blocks.back().memory;
+}
+
+/**
+ * Empties the arena, making all of its memory available again. Anything
+ * allocated from it must no longer be used. When the arena had grown past a
+ * single block, its blocks are replaced with one block large enough for all of
+ * them, so the same workload fits without allocating next time.
+ */
+void Arena::reset() {
+    if (this->blocks.size() > 1) {
+        size_t capacity = this->getCapacity();
+
+        for (Block &block : this->blocks) {
+            ::operator delete(block.memory);
+        }
+        this->blocks.clear();
+
+        this->blocks.push_back(
+            Block{(char *)::operator new(capacity), capacity});
+    }
+
+    this->used = 0;
+    this->previousBlocksUsed = 0;
+}
+
+/**
+ * Gets the number of bytes handed out since the arena was last reset,
+ * including padding and the space left at the end of full blocks.
+ *
+ * @return The number of bytes used.
+ */
+size_t Arena::getUsed() const { return this->previousBlocksUsed + this->used; }
+
+/**
+ * Gets the number of bytes held by the arena's blocks.
+ *
+ * @return The total size of every block.
+ */
+size_t Arena::getCapacity() const {
+    size_t capacity = 0;
+    for (const Block &block : this->blocks) {
+        capacity += block.size;
+    }
+
+    return capacity;
+}
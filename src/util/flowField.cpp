@@ -0,0 +1,117 @@
+// Distance map from every open tile to a single goal tile. Any number of
+// entities heading for the same goal can read their next step from it
+
+#include "Util/FlowField.hpp"
+#include "Maze/TileGrid.hpp"
+#include <cstddef>
+
+// Direction vectors containing moves to explore all adjacent cells
+const int flowXDirections[] = {1, -1, 0, 0};
+const int flowYDirections[] = {0, 0, -1, 1};
+
+/**
+ * Constructor for an empty FlowField with no goal.
+ *
+ * @param arena Arena to allocate the field's arrays from, or nullptr to use the
+ * heap.
+ */
+FlowField::FlowField(Arena *arena)
+    : map(nullptr), goal(-1), distances(ArenaAllocator<int>(arena)),
+      frontier(ArenaAllocator<int>(arena)) {}
+
+/**
+ * Recomputes the distance from every tile to a new goal with a breadth-first
+ * search. Every move costs the same, so a plain queue visits tiles in order of
+ * distance.
+ *
+ * @param map The grid of walls to search.
+ * @param goal Index of the goal tile.
+ */
+void FlowField::rebuild(TileGrid *map, int goal) {
+    this->map = map;
+    this->goal = goal;
+
+    size_t numTiles = size_t(map->getWidth()) * map->getHeight();
+    this->distances.assign(numTiles, -1);
+    this->frontier.resize(numTiles);
+
+    if (goal < 0)
+        return;
+
+    // The frontier array doubles as the queue since every tile enters it once
+    int head = 0;
+    int tail = 0;
+    this->distances[goal] = 0;
+    this->frontier[tail++] = goal;
+
+    while (head < tail) {
+        int current = this->frontier[head++];
+        int x = current % map->getWidth();
+        int y = current / map->getWidth();
+
+        for (int i = 0; i < 4; i++) {
+            int xNew = x + flowXDirections[i], yNew = y + flowYDirections[i];
+
+            if (map->isWall(xNew, yNew))
+                continue;
+
+            int neighbor = map->toIndex(xNew, yNew);
+            if (this->distances[neighbor] != -1)
+                continue;
+
+            this->distances[neighbor] = this->distances[current] + 1;
+            this->frontier[tail++] = neighbor;
+        }
+    }
+}
+
+/**
+ * Gets the tile the field leads to.
+ *
+ * @return Index of the goal tile, or -1 if the field has not been built.
+ */
+int FlowField::getGoal() { return this->goal; }
+
+/**
+ * Gets the number of moves needed to reach the goal from a tile.
+ *
+ * @param tile Index of the tile.
+ * @return The distance to the goal, or -1 if the goal cannot be reached.
+ */
+int FlowField::getDistance(int tile) {
+    if (tile < 0 || tile >= (int)this->distances.size())
+        return -1;
+
+    return this->distances[tile];
+}
+
+/**
+ * Finds the adjacent tile to move to in order to get closer to the goal.
+ *
+ * @param tile Index of the current tile.
+ * @return Index of a neighbouring tile one move closer to the goal, or -1 if
+ * the tile is the goal or cannot reach it.
+ */
+int FlowField::getNextStep(int tile) {
+    int distance = this->getDistance(tile);
+
+    if (distance <= 0)
+        return -1;
+
+    int x = tile % this->map->getWidth();
+    int y = tile / this->map->getWidth();
+
+    // Any open neighbour that is one move closer lies on a shortest path
+    for (int i = 0; i < 4; i++) {
+        int xNew = x + flowXDirections[i], yNew = y + flowYDirections[i];
+
+        if (!this->map->isInBounds(xNew, yNew))
+            continue;
+
+        int neighbor = this->map->toIndex(xNew, yNew);
+        if (this->distances[neighbor] == distance - 1)
+            return neighbor;
+    }
+
+    return -1;
+}
@@ -0,0 +1,49 @@
+// Process-wide cache of opened fonts, so that every piece of text drawn with
+// the same font file and size shares one TTF_Font
+
+#include "Util/FontCache.hpp"
+#include <iostream>
+
+std::map<std::pair<std::string, int>, TTF_Font *> FontCache::fonts;
+
+/**
+ * Gets a font at a given size, opening it the first time it is asked for.
+ * The font stays open until the cache is cleared.
+ *
+ * @param filePath The path to the font file.
+ * @param size The point size of the font.
+ * @return The font, or NULL if it could not be opened.
+ */
+TTF_Font *FontCache::getFont(const std::string &filePath, int size) {
+    auto key = std::make_pair(filePath, size);
+    auto it = fonts.find(key);
+
+    if (it != fonts.end()) {
+        return it->second;
+    }
+
+    TTF_Font *font = TTF_OpenFont(filePath.c_str(), size);
+
+    // Check if the font loading was successful
+    if (font == NULL) {
+        std::cout << "FAILED TO LOAD FONT. SDL_ERROR: " << SDL_GetError()
+                  << "\n";
+    }
+
+    fonts[key] = font;
+
+    return font;
+}
+
+/**
+ * Closes every cached font. Must be called before TTF_Quit.
+ */
+void FontCache::clear() {
+    for (auto &entry : fonts) {
+        if (entry.second != NULL) {
+            TTF_CloseFont(entry.second);
+        }
+    }
+
+    fonts.clear();
+}
@@ -0,0 +1,149 @@
+// Every printable ASCII character of a font rasterized once into a single
+// texture, so that text can be laid out as quads without touching SDL_ttf
+
+#include "Util/GlyphAtlas.hpp"
+#include "Util/FontCache.hpp"
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <iostream>
+
+// Number of characters packed into each row of the atlas
+const int GLYPHS_PER_ROW = 16;
+
+// Empty pixels left around every glyph so that neighbouring glyphs never bleed
+// into each other when sampled
+const int GLYPH_PADDING = 1;
+
+/**
+ * Constructor for the GlyphAtlas class. The atlas is empty until build() is
+ * called.
+ */
+GlyphAtlas::GlyphAtlas() : texture(NULL), glyphs(), lineHeight(0) {}
+
+/**
+ * Rasterizes every printable character of a font in white and packs them into
+ * a grid on one texture.
+ *
+ * @param renderer The renderer that will own the atlas texture.
+ * @param fontPath The path to the font file.
+ * @param fontSize The point size to rasterize the font at.
+ * @return True if the atlas texture was created, false otherwise.
+ */
+bool GlyphAtlas::build(SDL_Renderer *renderer, const char *fontPath,
+                       int fontSize) {
+    this->destroy();
+
+    TTF_Font *font = FontCache::getFont(fontPath, fontSize);
+    if (font == NULL)
+        return false;
+
+    const int numGlyphs = LAST_GLYPH - FIRST_GLYPH + 1;
+    SDL_Surface *surfaces[numGlyphs];
+    SDL_Color white = {255, 255, 255, 255};
+    int cellWidth = 0;
+    int cellHeight = 0;
+
+    // Rasterize every glyph and find the largest, which sets the cell size
+    for (int i = 0; i < numGlyphs; i++) {
+        Uint16 c = FIRST_GLYPH + i;
+        surfaces[i] = TTF_RenderGlyph_Blended(font, c, white);
+
+        int advance = 0;
+        TTF_GlyphMetrics(font, c, NULL, NULL, NULL, NULL, &advance);
+        this->glyphs[i].advance = advance;
+
+        if (surfaces[i] != NULL) {
+            cellWidth = std::max(cellWidth, surfaces[i]->w);
+            cellHeight = std::max(cellHeight, surfaces[i]->h);
+        }
+    }
+
+    this->lineHeight = TTF_FontHeight(font);
+
+    int rows = (numGlyphs + GLYPHS_PER_ROW - 1) / GLYPHS_PER_ROW;
+    SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(
+        0, GLYPHS_PER_ROW * (cellWidth + 2 * GLYPH_PADDING),
+        rows * (cellHeight + 2 * GLYPH_PADDING), 32, SDL_PIXELFORMAT_RGBA32);
+
+    // Copy pixels verbatim, including their alpha, instead of blending
+    for (int i = 0; i < numGlyphs; i++) {
+        SDL_Rect &rect = this->glyphs[i].rect;
+        rect = SDL_Rect{0, 0, 0, 0};
+
+        if (surfaces[i] == NULL)
+            continue;
+
+        rect.x = (i % GLYPHS_PER_ROW) * (cellWidth + 2 * GLYPH_PADDING) +
+                 GLYPH_PADDING;
+        rect.y = (i / GLYPHS_PER_ROW) * (cellHeight + 2 * GLYPH_PADDING) +
+                 GLYPH_PADDING;
+        rect.w = surfaces[i]->w;
+        rect.h = surfaces[i]->h;
+
+        if (atlasSurface != NULL) {
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], NULL, atlasSurface, &rect);
+        }
+
+        SDL_FreeSurface(surfaces[i]);
+    }
+
+    if (atlasSurface != NULL) {
+        this->texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+        SDL_FreeSurface(atlasSurface);
+    }
+
+    if (this->texture == NULL) {
+        std::cout << "FAILED TO CREATE GLYPH ATLAS. SDL_ERROR: "
+                  << SDL_GetError() << "\n";
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(this->texture, SDL_BLENDMODE_BLEND);
+
+    return true;
+}
+
+/**
+ * Checks whether the atlas texture has been created.
+ *
+ * @return True if build() has produced a texture, false otherwise.
+ */
+bool GlyphAtlas::isBuilt() { return this->texture != NULL; }
+
+/**
+ * Gets the texture every glyph is packed into.
+ *
+ * @return The atlas texture, or NULL if it has not been built.
+ */
+SDL_Texture *GlyphAtlas::getTexture() { return this->texture; }
+
+/**
+ * Looks up where a character is within the atlas.
+ *
+ * @param c The character to look up.
+ * @return The glyph, or nullptr if the character is not in the atlas.
+ */
+const GlyphAtlas::Glyph *GlyphAtlas::getGlyph(char c) {
+    if (c < FIRST_GLYPH || c > LAST_GLYPH)
+        return nullptr;
+
+    return &this->glyphs[c - FIRST_GLYPH];
+}
+
+/**
+ * Gets the distance between the tops of two lines of text.
+ *
+ * @return The line height in pixels.
+ */
+int GlyphAtlas::getLineHeight() { return this->lineHeight; }
+
+/**
+ * Frees the atlas texture.
+ */
+void GlyphAtlas::destroy() {
+    if (this->texture != NULL) {
+        SDL_DestroyTexture(this->texture);
+        this->texture = NULL;
+    }
+}
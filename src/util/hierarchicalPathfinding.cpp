@@ -0,0 +1,757 @@
+// Hierarchical pathfinding (HPA*) for large maps. The map is split into square
+// clusters connected through entrances on their borders. Paths are planned
+// over the small graph of entrances and only refined tile by tile inside the
+// cluster the searcher is in
+
+#include "Util/HierarchicalPathfinding.hpp"
+#include "Maze/TileGrid.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+// Openings on a cluster border at least this long get an entrance at each end
+// instead of a single one in the middle, so paths do not detour through it
+const int LONG_ENTRANCE_LENGTH = 6;
+
+/**
+ * Constructor for an empty HierarchicalMap. Nothing can be searched until
+ * build() is called.
+ */
+HierarchicalMap::HierarchicalMap()
+    : map(nullptr), clusterSize(1), clustersX(0), clustersY(0),
+      changeCursor(0) {}
+
+/**
+ * Splits the map into clusters and precomputes the entrances between them and
+ * the distances between entrances of the same cluster.
+ *
+ * @param map The grid of walls to build the graph over.
+ * @param clusterSize Number of tiles along each side of a cluster.
+ */
+void HierarchicalMap::build(TileGrid *map, int clusterSize) {
+    this->map = map;
+    this->clusterSize = clusterSize;
+    this->clustersX = (map->getWidth() + clusterSize - 1) / clusterSize;
+    this->clustersY = (map->getHeight() + clusterSize - 1) / clusterSize;
+    this->changeCursor = map->getChangeCount();
+
+    int numClusters = this->clustersX * this->clustersY;
+    this->clusters.assign(numClusters, std::vector<Node>());
+    this->verticalBorders.assign(numClusters,
+                                 std::vector<std::pair<int, int>>());
+    this->horizontalBorders.assign(numClusters,
+                                   std::vector<std::pair<int, int>>());
+    this->nodeIndices.assign(size_t(map->getWidth()) * map->getHeight(), -1);
+
+    for (int clusterY = 0; clusterY < this->clustersY; clusterY++) {
+        for (int clusterX = 0; clusterX < this->clustersX; clusterX++) {
+            this->buildBorders(clusterX, clusterY);
+        }
+    }
+
+    for (int clusterY = 0; clusterY < this->clustersY; clusterY++) {
+        for (int clusterX = 0; clusterX < this->clustersX; clusterX++) {
+            this->buildNodes(clusterX, clusterY);
+        }
+    }
+
+    for (int cluster = 0; cluster < numClusters; cluster++) {
+        this->buildEdges(cluster);
+    }
+
+    this->numberNodes();
+}
+
+/**
+ * Finds the entrances along one cluster border. Each maximal opening where
+ * both facing tiles are open gets one or two entrances.
+ *
+ * @param ax The x coordinate of the first tile on the near side.
+ * @param ay The y coordinate of the first tile on the near side.
+ * @param bx The x coordinate of the first tile on the far side.
+ * @param by The y coordinate of the first tile on the far side.
+ * @param length Number of tiles along the border.
+ * @param stepX Step along the border on the x-axis.
+ * @param stepY Step along the border on the y-axis.
+ * @param border Filled with the pairs of facing entrance tiles.
+ */
+void HierarchicalMap::findTransitions(
+    int ax, int ay, int bx, int by, int length, int stepX, int stepY,
+    std::vector<std::pair<int, int>> *border) {
+    border->clear();
+
+    int runStart = -1;
+
+    // Step one past the end so that an opening reaching it is closed off
+    for (int i = 0; i <= length; i++) {
+        bool isOpen = i < length &&
+                      !this->map->isWall(ax + i * stepX, ay + i * stepY) &&
+                      !this->map->isWall(bx + i * stepX, by + i * stepY);
+
+        if (isOpen && runStart == -1) {
+            runStart = i;
+        } else if (!isOpen && runStart != -1) {
+            int runEnd = i - 1;
+            int positions[2] = {(runStart + runEnd) / 2, -1};
+
+            if (runEnd - runStart + 1 >= LONG_ENTRANCE_LENGTH) {
+                positions[0] = runStart;
+                positions[1] = runEnd;
+            }
+
+            for (int position : positions) {
+                if (position == -1)
+                    continue;
+
+                border->push_back(
+                    {this->map->toIndex(ax + position * stepX,
+                                        ay + position * stepY),
+                     this->map->toIndex(bx + position * stepX,
+                                        by + position * stepY)});
+            }
+
+            runStart = -1;
+        }
+    }
+}
+
+/**
+ * Finds the entrances on the four borders of a cluster.
+ *
+ * @param clusterX The x coordinate of the cluster.
+ * @param clusterY The y coordinate of the cluster.
+ */
+void HierarchicalMap::buildBorders(int clusterX, int clusterY) {
+    for (int dx = -1; dx <= 0; dx++) {
+        // Border between (clusterX + dx) and the cluster to its right
+        int leftX = clusterX + dx;
+        if (leftX < 0 || leftX + 1 >= this->clustersX)
+            continue;
+
+        int x, y, width, height;
+        this->getClusterBounds(clusterY * this->clustersX + leftX, &x, &y,
+                               &width, &height);
+        this->findTransitions(
+            x + width - 1, y, x + width, y, height, 0, 1,
+            &this->verticalBorders[clusterY * this->clustersX + leftX]);
+    }
+
+    for (int dy = -1; dy <= 0; dy++) {
+        // Border between (clusterY + dy) and the cluster below it
+        int topY = clusterY + dy;
+        if (topY < 0 || topY + 1 >= this->clustersY)
+            continue;
+
+        int x, y, width, height;
+        this->getClusterBounds(topY * this->clustersX + clusterX, &x, &y,
+                               &width, &height);
+        this->findTransitions(
+            x, y + height - 1, x, y + height, width, 1, 0,
+            &this->horizontalBorders[topY * this->clustersX + clusterX]);
+    }
+}
+
+/**
+ * Adds an entrance to a cluster, or another partner to an existing one.
+ *
+ * @param cluster Index of the cluster.
+ * @param tile Index of the entrance tile.
+ * @param partner Index of the facing tile in the adjacent cluster.
+ */
+void HierarchicalMap::addNode(int cluster, int tile, int partner) {
+    std::vector<Node> &nodes = this->clusters[cluster];
+
+    if (this->nodeIndices[tile] == -1) {
+        this->nodeIndices[tile] = nodes.size();
+        nodes.push_back(Node{tile, -1, {}, {}});
+    }
+
+    // Node ids are filled in once every cluster has its entrances
+    nodes[this->nodeIndices[tile]].partners.push_back(Edge{partner, -1, 1});
+}
+
+/**
+ * Collects the entrances of a cluster from its four borders.
+ *
+ * @param clusterX The x coordinate of the cluster.
+ * @param clusterY The y coordinate of the cluster.
+ */
+void HierarchicalMap::buildNodes(int clusterX, int clusterY) {
+    int cluster = clusterY * this->clustersX + clusterX;
+
+    for (Node &node : this->clusters[cluster]) {
+        this->nodeIndices[node.tile] = -1;
+    }
+    this->clusters[cluster].clear();
+
+    if (clusterX > 0) {
+        for (auto &transition : this->verticalBorders[cluster - 1]) {
+            this->addNode(cluster, transition.second, transition.first);
+        }
+    }
+
+    if (clusterX + 1 < this->clustersX) {
+        for (auto &transition : this->verticalBorders[cluster]) {
+            this->addNode(cluster, transition.first, transition.second);
+        }
+    }
+
+    if (clusterY > 0) {
+        for (auto &transition :
+             this->horizontalBorders[cluster - this->clustersX]) {
+            this->addNode(cluster, transition.second, transition.first);
+        }
+    }
+
+    if (clusterY + 1 < this->clustersY) {
+        for (auto &transition : this->horizontalBorders[cluster]) {
+            this->addNode(cluster, transition.first, transition.second);
+        }
+    }
+}
+
+/**
+ * Computes the distances between every pair of entrances of a cluster with a
+ * breadth-first search that stays inside it.
+ *
+ * @param cluster Index of the cluster.
+ */
+void HierarchicalMap::buildEdges(int cluster) {
+    int clusterX, clusterY, width, height;
+    this->getClusterBounds(cluster, &clusterX, &clusterY, &width, &height);
+
+    // Copy the cluster's walls into a local array with a one tile wall border,
+    // so that the searches need neither bounds checks nor divisions
+    int stride = width + 2;
+    int numTiles = stride * (height + 2);
+    this->openTiles.assign(numTiles, 0);
+    this->frontier.resize(numTiles);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            this->openTiles[(y + 1) * stride + x + 1] =
+                !this->map->isWall(clusterX + x, clusterY + y);
+        }
+    }
+
+    const int offsets[] = {1, -1, -stride, stride};
+    std::vector<Node> &nodes = this->clusters[cluster];
+    int mapWidth = this->map->getWidth();
+
+    auto toLocal = [&](int tile) {
+        return (tile / mapWidth - clusterY + 1) * stride + tile % mapWidth -
+               clusterX + 1;
+    };
+
+    for (Node &node : nodes) {
+        node.edges.clear();
+        this->distances.assign(numTiles, -1);
+
+        int head = 0;
+        int tail = 0;
+        int local = toLocal(node.tile);
+        this->distances[local] = 0;
+        this->frontier[tail++] = local;
+
+        while (head < tail) {
+            int current = this->frontier[head++];
+
+            for (int offset : offsets) {
+                int neighbor = current + offset;
+
+                if (!this->openTiles[neighbor] ||
+                    this->distances[neighbor] != -1)
+                    continue;
+
+                this->distances[neighbor] = this->distances[current] + 1;
+                this->frontier[tail++] = neighbor;
+            }
+        }
+
+        for (Node &other : nodes) {
+            int distance = this->distances[toLocal(other.tile)];
+
+            if (&other != &node && distance > 0) {
+                node.edges.push_back(Edge{other.tile, -1, distance});
+            }
+        }
+    }
+}
+
+/**
+ * Rebuilds the entrances on the borders of a cluster, along with the
+ * entrances and internal distances of it and its four neighbours.
+ *
+ * @param clusterX The x coordinate of the cluster.
+ * @param clusterY The y coordinate of the cluster.
+ */
+void HierarchicalMap::rebuildCluster(int clusterX, int clusterY) {
+    this->buildBorders(clusterX, clusterY);
+
+    const int xOffsets[] = {0, 1, -1, 0, 0};
+    const int yOffsets[] = {0, 0, 0, -1, 1};
+
+    for (int i = 0; i < 5; i++) {
+        int x = clusterX + xOffsets[i];
+        int y = clusterY + yOffsets[i];
+
+        if (x < 0 || x >= this->clustersX || y < 0 || y >= this->clustersY)
+            continue;
+
+        this->buildNodes(x, y);
+        this->buildEdges(y * this->clustersX + x);
+    }
+}
+
+/**
+ * Numbers the entrances cluster by cluster, and points every edge at the
+ * number of the entrance it leads to. The numbers change whenever a cluster
+ * is rebuilt, so they are only good until the next update.
+ */
+void HierarchicalMap::numberNodes() {
+    this->clusterOffsets.resize(this->clusters.size() + 1);
+    this->clusterOffsets[0] = 0;
+
+    for (size_t i = 0; i < this->clusters.size(); i++) {
+        this->clusterOffsets[i + 1] =
+            this->clusterOffsets[i] + this->clusters[i].size();
+    }
+
+    this->nodesById.resize(this->clusterOffsets.back());
+
+    for (size_t i = 0; i < this->clusters.size(); i++) {
+        for (Node &node : this->clusters[i]) {
+            node.id = this->clusterOffsets[i] + this->nodeIndices[node.tile];
+            this->nodesById[node.id] = &node;
+
+            for (Edge &partner : node.partners) {
+                partner.node = this->getNodeId(partner.tile);
+            }
+
+            for (Edge &edge : node.edges) {
+                edge.node = this->clusterOffsets[i] +
+                            this->nodeIndices[edge.tile];
+            }
+        }
+    }
+}
+
+/**
+ * Applies the grid's wall changes since the last update, rebuilding only the
+ * clusters they touched.
+ */
+void HierarchicalMap::update() {
+    std::vector<int> changedClusters;
+
+    while (this->changeCursor < this->map->getChangeCount()) {
+        int cluster =
+            this->getClusterOf(this->map->getChange(this->changeCursor++));
+
+        if (std::find(changedClusters.begin(), changedClusters.end(),
+                      cluster) == changedClusters.end()) {
+            changedClusters.push_back(cluster);
+        }
+    }
+
+    for (int cluster : changedClusters) {
+        this->rebuildCluster(cluster % this->clustersX,
+                             cluster / this->clustersX);
+    }
+
+    if (!changedClusters.empty()) {
+        this->numberNodes();
+    }
+}
+
+/**
+ * Gets the grid the graph was built over.
+ *
+ * @return Pointer to the grid.
+ */
+TileGrid *HierarchicalMap::getMap() { return this->map; }
+
+/**
+ * Points the graph at another grid holding the same walls as the one it was
+ * built over, such as after that grid was moved into its final place.
+ *
+ * @param map The grid to read walls and changes from.
+ */
+void HierarchicalMap::setMap(TileGrid *map) { this->map = map; }
+
+/**
+ * Gets the cluster a tile belongs to.
+ *
+ * @param tile Index of the tile.
+ * @return Index of the cluster.
+ */
+int HierarchicalMap::getClusterOf(int tile) {
+    int x = tile % this->map->getWidth() / this->clusterSize;
+    int y = tile / this->map->getWidth() / this->clusterSize;
+
+    return y * this->clustersX + x;
+}
+
+/**
+ * Gets the tiles covered by a cluster. Clusters on the right and bottom edges
+ * of the map may be smaller than the others.
+ *
+ * @param cluster Index of the cluster.
+ * @param x Filled with the x coordinate of the cluster's top-left tile.
+ * @param y Filled with the y coordinate of the cluster's top-left tile.
+ * @param width Filled with the number of tiles along the x-axis.
+ * @param height Filled with the number of tiles along the y-axis.
+ */
+void HierarchicalMap::getClusterBounds(int cluster, int *x, int *y, int *width,
+                                       int *height) {
+    *x = cluster % this->clustersX * this->clusterSize;
+    *y = cluster / this->clustersX * this->clusterSize;
+    *width = std::min(this->clusterSize, this->map->getWidth() - *x);
+    *height = std::min(this->clusterSize, this->map->getHeight() - *y);
+}
+
+/**
+ * Gets the entrances of a cluster.
+ *
+ * @param cluster Index of the cluster.
+ * @return Pointer to the cluster's entrances.
+ */
+std::vector<HierarchicalMap::Node> *HierarchicalMap::getNodes(int cluster) {
+    return &this->clusters[cluster];
+}
+
+/**
+ * Gets the entrance at a tile.
+ *
+ * @param tile Index of the tile.
+ * @return Pointer to the entrance, or nullptr if the tile is not one.
+ */
+HierarchicalMap::Node *HierarchicalMap::getNode(int tile) {
+    int index = this->nodeIndices[tile];
+
+    if (index == -1)
+        return nullptr;
+
+    return &this->clusters[this->getClusterOf(tile)][index];
+}
+
+/**
+ * Gets the number of entrances across every cluster.
+ *
+ * @return The number of entrances, one more than the largest node id.
+ */
+int HierarchicalMap::getNodeCount() { return this->clusterOffsets.back(); }
+
+/**
+ * Gets the number of the entrance at a tile, which searches index their
+ * per-entrance arrays with. Numbers run from 0 up to the number of entrances.
+ *
+ * @param tile Index of the tile.
+ * @return The node id, or -1 if the tile is not an entrance.
+ */
+int HierarchicalMap::getNodeId(int tile) {
+    int index = this->nodeIndices[tile];
+
+    if (index == -1)
+        return -1;
+
+    return this->clusterOffsets[this->getClusterOf(tile)] + index;
+}
+
+/**
+ * Gets the entrance with a node id.
+ *
+ * @param id The node id, from 0 up to the number of entrances.
+ * @return Pointer to the entrance.
+ */
+HierarchicalMap::Node *HierarchicalMap::getNodeById(int id) {
+    return this->nodesById[id];
+}
+
+/**
+ * Constructor for the HierarchicalPathSearch class. Its arrays are sized
+ * lazily by the first search.
+ *
+ * @param arena Arena to allocate the search's arrays from, or nullptr to use
+ * the heap.
+ */
+HierarchicalPathSearch::HierarchicalPathSearch(Arena *arena)
+    : startSearch(arena), goalSearch(arena), scores(arena), open(arena),
+      expandedCount(0) {}
+
+/**
+ * Constructor for an empty LocalSearch, sized by the first cluster searched.
+ *
+ * @param arena Arena to allocate the search's arrays from, or nullptr to use
+ * the heap.
+ */
+HierarchicalPathSearch::LocalSearch::LocalSearch(Arena *arena)
+    : x(0), y(0), stride(0), height(0),
+      openTiles(ArenaAllocator<uint8_t>(arena)),
+      distances(ArenaAllocator<int>(arena)),
+      parents(ArenaAllocator<int>(arena)),
+      frontier(ArenaAllocator<int>(arena)) {}
+
+/**
+ * Prepares the search arrays for a new search by advancing the generation
+ * counter so that old entries become stale. The arrays only need one entry
+ * per entrance, rather than one per tile.
+ *
+ * @param graph The graph about to be searched.
+ */
+void HierarchicalPathSearch::reset(HierarchicalMap *graph) {
+    this->scores.reset(graph->getNodeCount());
+    this->open.clear();
+    this->expandedCount = 0;
+}
+
+/**
+ * Runs a breadth-first search from a tile that stays inside its cluster.
+ *
+ * @param graph The graph the cluster belongs to.
+ * @param cluster Index of the cluster.
+ * @param from Index of the tile to search from.
+ * @param search Filled with the distance to and parent of every tile.
+ */
+void HierarchicalPathSearch::searchCluster(HierarchicalMap *graph, int cluster,
+                                           int from, LocalSearch *search) {
+    TileGrid *map = graph->getMap();
+    int width, height;
+    graph->getClusterBounds(cluster, &search->x, &search->y, &width, &height);
+
+    // Copy the cluster's walls into a local array with a one tile wall border,
+    // so that the search needs neither bounds checks nor divisions
+    search->stride = width + 2;
+    search->height = height;
+
+    int numTiles = search->stride * (height + 2);
+    search->openTiles.assign(numTiles, 0);
+    search->distances.assign(numTiles, -1);
+    search->parents.resize(numTiles);
+    search->frontier.resize(numTiles);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            search->openTiles[(y + 1) * search->stride + x + 1] =
+                !map->isWall(search->x + x, search->y + y);
+        }
+    }
+
+    const int offsets[] = {1, -1, -search->stride, search->stride};
+
+    int head = 0;
+    int tail = 0;
+    int local = this->toLocal(search, map, from);
+    search->distances[local] = 0;
+    search->parents[local] = -1;
+    search->frontier[tail++] = local;
+
+    while (head < tail) {
+        int current = search->frontier[head++];
+        this->expandedCount++;
+
+        for (int offset : offsets) {
+            int neighbor = current + offset;
+
+            if (!search->openTiles[neighbor] ||
+                search->distances[neighbor] != -1)
+                continue;
+
+            search->distances[neighbor] = search->distances[current] + 1;
+            search->parents[neighbor] = current;
+            search->frontier[tail++] = neighbor;
+        }
+    }
+}
+
+/**
+ * Converts a map tile to its position in a local search's arrays.
+ *
+ * @param search The local search.
+ * @param map The grid the search ran on.
+ * @param tile Index of the tile.
+ * @return Index into the search's arrays, or -1 if the tile is outside the
+ * cluster.
+ */
+int HierarchicalPathSearch::toLocal(LocalSearch *search, TileGrid *map,
+                                    int tile) {
+    int x = tile % map->getWidth() - search->x;
+    int y = tile / map->getWidth() - search->y;
+
+    if (x < 0 || x >= search->stride - 2 || y < 0 || y >= search->height)
+        return -1;
+
+    return (y + 1) * search->stride + x + 1;
+}
+
+/**
+ * Gets the distance found by a local search to a tile.
+ *
+ * @param search The local search.
+ * @param map The grid the search ran on.
+ * @param tile Index of the tile.
+ * @return The distance, or -1 if the tile is outside the cluster or was not
+ * reached.
+ */
+int HierarchicalPathSearch::getLocalDistance(LocalSearch *search,
+                                             TileGrid *map, int tile) {
+    int local = this->toLocal(search, map, tile);
+
+    return local == -1 ? -1 : search->distances[local];
+}
+
+/**
+ * Walks back along a local search from a target to find the first step taken
+ * from the start.
+ *
+ * @param search The local search, run from the start.
+ * @param map The grid the search ran on.
+ * @param start Index of the tile the search ran from.
+ * @param target Index of a tile reached by the search.
+ * @return Index of the tile after the start, or -1 if there is none.
+ */
+int HierarchicalPathSearch::findLocalStep(LocalSearch *search, TileGrid *map,
+                                          int start, int target) {
+    if (target == start || this->getLocalDistance(search, map, target) < 0)
+        return -1;
+
+    int current = this->toLocal(search, map, target);
+
+    while (search->distances[current] > 1) {
+        current = search->parents[current];
+    }
+
+    return map->toIndex(search->x + current % search->stride - 1,
+                        search->y + current / search->stride - 1);
+}
+
+/**
+ * Finds the tile to move to next in order to get from the start tile to the
+ * goal tile. The route is planned over cluster entrances and only refined
+ * inside the start's cluster, so it may be slightly longer than the shortest
+ * path.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param graph The graph of entrances to plan over.
+ * @return Index of the tile adjacent to start on the path, or -1 if the goal
+ * is the start or cannot be reached.
+ */
+int HierarchicalPathSearch::findNextStep(int start, int goal,
+                                         HierarchicalMap *graph) {
+    TileGrid *map = graph->getMap();
+
+    if (start == goal)
+        return -1;
+
+    this->reset(graph);
+
+    int startCluster = graph->getClusterOf(start);
+    int goalCluster = graph->getClusterOf(goal);
+
+    // Walk straight there when the goal can be reached without leaving the
+    // cluster
+    this->searchCluster(graph, startCluster, start, &this->startSearch);
+    if (startCluster == goalCluster &&
+        this->getLocalDistance(&this->startSearch, map, goal) >= 0) {
+        return this->findLocalStep(&this->startSearch, map, start, goal);
+    }
+
+    this->searchCluster(graph, goalCluster, goal, &this->goalSearch);
+
+    int width = map->getWidth();
+    int goalX = goal % width;
+    int goalY = goal / width;
+
+    // Connect the start to every entrance of its cluster it can reach
+    for (HierarchicalMap::Node &node : *graph->getNodes(startCluster)) {
+        int distance =
+            this->getLocalDistance(&this->startSearch, map, node.tile);
+        if (distance < 0)
+            continue;
+
+        int h = abs(node.tile % width - goalX) + abs(node.tile / width - goalY);
+        this->scores.visit(node.id) = PathScore{distance, -1};
+        this->open.push(OpenNode{distance + h, h, distance, node.id});
+    }
+
+    int bestCost = INT_MAX;
+    int bestNode = -1;
+
+    // A* over the entrances until no cheaper way to the goal can remain
+    while (!this->open.isEmpty()) {
+        OpenNode current = this->open.pop();
+
+        if (current.gScore != this->scores[current.node].gScore)
+            continue;
+
+        if (current.fScore >= bestCost)
+            break;
+
+        this->expandedCount++;
+
+        HierarchicalMap::Node *node = graph->getNodeById(current.node);
+
+        // Entrances of the goal's cluster lead straight to the goal
+        int toGoal = this->getLocalDistance(&this->goalSearch, map, node->tile);
+        if (toGoal >= 0 && current.gScore + toGoal < bestCost) {
+            bestCost = current.gScore + toGoal;
+            bestNode = current.node;
+        }
+
+        auto relax = [&](const HierarchicalMap::Edge &edge) {
+            int tentativeGScore = current.gScore + edge.cost;
+
+            if (this->scores.isVisited(edge.node) &&
+                this->scores[edge.node].gScore <= tentativeGScore)
+                return;
+
+            int h = abs(edge.tile % width - goalX) +
+                    abs(edge.tile / width - goalY);
+            this->scores.visit(edge.node) =
+                PathScore{tentativeGScore, current.node};
+            this->open.push(
+                OpenNode{tentativeGScore + h, h, tentativeGScore, edge.node});
+        };
+
+        for (HierarchicalMap::Edge &partner : node->partners) {
+            relax(partner);
+        }
+
+        for (HierarchicalMap::Edge &edge : node->edges) {
+            relax(edge);
+        }
+    }
+
+    if (bestNode == -1)
+        return -1;
+
+    // Find the first entrance on the route, and the one after it
+    int first = bestNode;
+    int second = -1;
+    while (this->scores[first].parent != -1) {
+        second = first;
+        first = this->scores[first].parent;
+    }
+
+    // If the start is an entrance itself, head for the next one instead
+    int target = graph->getNodeById(first)->tile;
+    if (target == start) {
+        if (second == -1)
+            return -1;
+
+        target = graph->getNodeById(second)->tile;
+    }
+
+    // Crossing into the neighbouring cluster is a single step
+    if (graph->getClusterOf(target) != startCluster)
+        return target;
+
+    return this->findLocalStep(&this->startSearch, map, start, target);
+}
+
+/**
+ * Gets the number of tiles and entrances expanded by the most recent search.
+ *
+ * @return The number of expanded tiles and entrances.
+ */
+int HierarchicalPathSearch::getExpandedCount() { return this->expandedCount; }
@@ -0,0 +1,390 @@
+// Incremental A* (Lifelong Planning A*) that repairs its previous search
+// instead of starting over when the goal moves or walls change
+
+#include "Util/IncrementalPathSearch.hpp"
+#include "Maze/TileGrid.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+// Direction vectors containing moves to explore all adjacent cells
+const int incrementalXDirections[] = {1, -1, 0, 0};
+const int incrementalYDirections[] = {0, 0, -1, 1};
+
+// Cost of a tile that cannot be reached
+const int UNREACHABLE = INT_MAX;
+
+/**
+ * Constructor for the IncrementalPathSearch class. Nothing is searched until
+ * the first call to findNextStep.
+ *
+ * @param arena Arena to allocate the search's arrays from, or nullptr to use
+ * the heap.
+ */
+IncrementalPathSearch::IncrementalPathSearch(Arena *arena)
+    : map(nullptr), start(-1), goal(-1), nextStep(-1), changeCursor(0),
+      isDirty(true), scores(arena), open(arena), expandedCount(0) {}
+
+/**
+ * Orders open list entries by their keys, breaking ties with the tile index
+ * so that searches are deterministic.
+ *
+ * @param a The first entry.
+ * @param b The second entry.
+ * @return True if a should be expanded before b.
+ */
+bool IncrementalPathSearch::QueueEntry::isBefore(const QueueEntry &a,
+                                                 const QueueEntry &b) {
+    if (a.primaryKey != b.primaryKey)
+        return a.primaryKey < b.primaryKey;
+    if (a.secondaryKey != b.secondaryKey)
+        return a.secondaryKey < b.secondaryKey;
+    return a.tile < b.tile;
+}
+
+/**
+ * Throws away the previous search and roots a new one at the start tile. The
+ * goal must already be set, since it is needed to queue the start.
+ *
+ * @param map The grid of walls to search.
+ * @param start Index of the starting tile.
+ */
+void IncrementalPathSearch::reset(TileGrid *map, int start) {
+    this->scores.reset(size_t(map->getWidth()) * map->getHeight());
+
+    this->map = map;
+    this->start = start;
+    this->changeCursor = map->getChangeCount();
+    this->open.clear();
+
+    // The start is the only tile known to be reachable
+    this->touch(start);
+    this->scores[start].rhsScore = 0;
+    this->pushHeap(start);
+}
+
+/**
+ * Makes sure a tile's score belongs to the current search, setting it to
+ * unvisited if it does not.
+ *
+ * @param tile Index of the tile.
+ */
+void IncrementalPathSearch::touch(int tile) {
+    if (this->scores.isVisited(tile))
+        return;
+
+    this->scores.visit(tile) =
+        TileScore{UNREACHABLE, UNREACHABLE, UNREACHABLE, UNREACHABLE, false};
+}
+
+/**
+ * Calculates the manhattan distance from a tile to the goal.
+ *
+ * @param tile Index of the tile.
+ * @return The heuristic value.
+ */
+int IncrementalPathSearch::heuristic(int tile) {
+    int width = this->map->getWidth();
+
+    return abs(tile % width - this->goal % width) +
+           abs(tile / width - this->goal / width);
+}
+
+/**
+ * Computes the priority of a tile from the smaller of its two distances.
+ *
+ * @param tile Index of the tile.
+ * @return An open list entry for the tile with that priority.
+ */
+IncrementalPathSearch::QueueEntry
+IncrementalPathSearch::calculateKey(int tile) {
+    const TileScore &score = this->scores[tile];
+    int distance = std::min(score.gScore, score.rhsScore);
+    int primaryKey = distance == UNREACHABLE
+                         ? UNREACHABLE
+                         : distance + this->heuristic(tile);
+
+    return QueueEntry{primaryKey, distance, tile};
+}
+
+/**
+ * Checks whether an open list entry was left behind when its tile was taken
+ * out of the queue or queued again with another key.
+ *
+ * @param entry The entry.
+ * @return True if the entry should be skipped.
+ */
+bool IncrementalPathSearch::isStale(const QueueEntry &entry) {
+    const TileScore &score = this->scores[entry.tile];
+
+    return !score.isQueued || score.primaryKey != entry.primaryKey ||
+           score.secondaryKey != entry.secondaryKey;
+}
+
+/**
+ * Queues a tile with a freshly computed key.
+ *
+ * @param tile Index of the tile.
+ */
+void IncrementalPathSearch::pushHeap(int tile) {
+    QueueEntry entry = this->calculateKey(tile);
+
+    TileScore &score = this->scores[tile];
+    score.primaryKey = entry.primaryKey;
+    score.secondaryKey = entry.secondaryKey;
+    score.isQueued = true;
+    this->open.push(entry);
+}
+
+/**
+ * Takes a tile out of the queue. Its entry is skipped once it reaches the
+ * front of the open list.
+ *
+ * @param tile Index of the tile.
+ */
+void IncrementalPathSearch::removeFromHeap(int tile) {
+    this->scores[tile].isQueued = false;
+}
+
+/**
+ * Finds the queued tile to expand next, dropping stale entries in front of
+ * it.
+ *
+ * @return Index of the tile, or -1 if the queue is empty.
+ */
+int IncrementalPathSearch::peekHeap() {
+    while (!this->open.isEmpty() && this->isStale(this->open.top())) {
+        this->open.pop();
+    }
+
+    return this->open.isEmpty() ? -1 : this->open.top().tile;
+}
+
+/**
+ * Recomputes every queued key after the goal moved and restores the heap,
+ * dropping stale entries on the way. Distances from the start do not depend
+ * on the goal, so everything already consistent stays valid.
+ */
+void IncrementalPathSearch::rekeyHeap() {
+    this->open.rebuild([this](QueueEntry *entry) {
+        if (this->isStale(*entry))
+            return false;
+
+        *entry = this->calculateKey(entry->tile);
+
+        TileScore &score = this->scores[entry->tile];
+        score.primaryKey = entry->primaryKey;
+        score.secondaryKey = entry->secondaryKey;
+        return true;
+    });
+}
+
+/**
+ * Recomputes a tile's lookahead distance from its neighbours and queues it if
+ * that leaves it inconsistent.
+ *
+ * @param tile Index of the tile.
+ */
+void IncrementalPathSearch::updateVertex(int tile) {
+    this->touch(tile);
+
+    int width = this->map->getWidth();
+    int x = tile % width;
+    int y = tile / width;
+
+    // The start is always reachable and walls never are
+    if (tile != this->start) {
+        int best = UNREACHABLE;
+
+        if (!this->map->isWall(x, y)) {
+            for (int i = 0; i < 4; i++) {
+                int xNew = x + incrementalXDirections[i];
+                int yNew = y + incrementalYDirections[i];
+
+                if (this->map->isWall(xNew, yNew))
+                    continue;
+
+                int neighbor = this->map->toIndex(xNew, yNew);
+                this->touch(neighbor);
+
+                if (this->scores[neighbor].gScore != UNREACHABLE) {
+                    best = std::min(best, this->scores[neighbor].gScore + 1);
+                }
+            }
+        }
+
+        this->scores[tile].rhsScore = best;
+    }
+
+    if (this->scores[tile].isQueued) {
+        this->removeFromHeap(tile);
+    }
+
+    if (this->scores[tile].gScore != this->scores[tile].rhsScore) {
+        this->pushHeap(tile);
+    }
+}
+
+/**
+ * Updates the lookahead distance of every tile adjacent to a tile.
+ *
+ * @param tile Index of the tile.
+ */
+void IncrementalPathSearch::updateNeighbors(int tile) {
+    int width = this->map->getWidth();
+    int x = tile % width;
+    int y = tile / width;
+
+    for (int i = 0; i < 4; i++) {
+        int xNew = x + incrementalXDirections[i];
+        int yNew = y + incrementalYDirections[i];
+
+        if (this->map->isInBounds(xNew, yNew)) {
+            this->updateVertex(this->map->toIndex(xNew, yNew));
+        }
+    }
+}
+
+/**
+ * Repairs the search around every wall added or removed since the last
+ * search.
+ */
+void IncrementalPathSearch::applyWallChanges() {
+    while (this->changeCursor < this->map->getChangeCount()) {
+        int tile = this->map->getChange(this->changeCursor++);
+
+        // Walls inside the search cannot affect it until they are reached
+        this->updateVertex(tile);
+        this->updateNeighbors(tile);
+        this->isDirty = true;
+    }
+}
+
+/**
+ * Expands inconsistent tiles until the goal's distance is known to be
+ * correct.
+ */
+void IncrementalPathSearch::computeShortestPath() {
+    this->touch(this->goal);
+    this->expandedCount = 0;
+
+    while (true) {
+        int top = this->peekHeap();
+        if (top == -1)
+            break;
+
+        TileScore &goalScore = this->scores[this->goal];
+        bool goalSettled = goalScore.rhsScore == goalScore.gScore;
+        QueueEntry goalEntry = this->calculateKey(this->goal);
+
+        if (goalSettled && !QueueEntry::isBefore(this->open.top(), goalEntry))
+            break;
+
+        this->removeFromHeap(top);
+        this->expandedCount++;
+
+        TileScore &score = this->scores[top];
+        if (score.gScore > score.rhsScore) {
+            // A shorter path was found; commit to it and tell the neighbours
+            score.gScore = score.rhsScore;
+            this->updateNeighbors(top);
+        } else {
+            // The old path got longer; forget it and let the tile and its
+            // neighbours find a new one
+            score.gScore = UNREACHABLE;
+            this->updateVertex(top);
+            this->updateNeighbors(top);
+        }
+    }
+}
+
+/**
+ * Walks back along the shortest path from the goal to find the tile right
+ * after the start.
+ *
+ * @return Index of the next tile, or -1 if the goal cannot be reached.
+ */
+int IncrementalPathSearch::extractNextStep() {
+    int current = this->goal;
+    int width = this->map->getWidth();
+
+    if (current == this->start || this->scores[current].gScore == UNREACHABLE)
+        return -1;
+
+    // Every step back lowers the distance by one, so this always terminates
+    while (this->scores[current].gScore > 1) {
+        int x = current % width;
+        int y = current / width;
+        int previous = -1;
+
+        for (int i = 0; i < 4; i++) {
+            int xNew = x + incrementalXDirections[i];
+            int yNew = y + incrementalYDirections[i];
+
+            if (this->map->isWall(xNew, yNew))
+                continue;
+
+            int neighbor = this->map->toIndex(xNew, yNew);
+            this->touch(neighbor);
+
+            if (this->scores[neighbor].gScore ==
+                this->scores[current].gScore - 1) {
+                previous = neighbor;
+                break;
+            }
+        }
+
+        if (previous == -1)
+            return -1;
+
+        current = previous;
+    }
+
+    return current;
+}
+
+/**
+ * Finds the tile to move to next in order to follow the shortest path from
+ * the start tile to the goal tile. Nothing is searched when neither tile nor
+ * the walls changed since the last call; a moved goal or changed walls only
+ * repair the previous search, and a moved start begins a new one. Followers
+ * pass their own tile as the start, since the player they chase moves more
+ * often than they do; `make bench-pathfinding` times this in its chases.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid of walls to search.
+ * @return Index of the tile adjacent to start on the path, or -1 if the goal
+ * is the start or cannot be reached.
+ */
+int IncrementalPathSearch::findNextStep(int start, int goal, TileGrid *map) {
+    if (map != this->map || start != this->start) {
+        this->goal = goal;
+        this->reset(map, start);
+        this->isDirty = true;
+    } else if (goal != this->goal) {
+        this->goal = goal;
+        this->rekeyHeap();
+        this->isDirty = true;
+    }
+
+    this->applyWallChanges();
+
+    if (!this->isDirty) {
+        this->expandedCount = 0;
+        return this->nextStep;
+    }
+
+    this->computeShortestPath();
+    this->nextStep = this->extractNextStep();
+    this->isDirty = false;
+
+    return this->nextStep;
+}
+
+/**
+ * Gets the number of tiles expanded by the most recent call to findNextStep.
+ *
+ * @return The number of expanded tiles.
+ */
+int IncrementalPathSearch::getExpandedCount() { return this->expandedCount; }
@@ -0,0 +1,69 @@
+// Player input for a single simulation tick, and the sources it can come
+// from. The simulation only ever sees InputStates, so it can be driven by the
+// keyboard, a bot or a recording alike
+
+#include "Util/Input.hpp"
+#include <SDL2/SDL.h>
+
+/**
+ * Reads the buttons currently held on the keyboard.
+ *
+ * @return The input for this tick.
+ */
+InputState KeyboardInput::poll() {
+    const Uint8 *keystate = SDL_GetKeyboardState(NULL);
+    InputState input = {0};
+
+    if (keystate[SDL_SCANCODE_W])
+        input.buttons |= INPUT_FORWARD;
+    if (keystate[SDL_SCANCODE_S])
+        input.buttons |= INPUT_BACK;
+    if (keystate[SDL_SCANCODE_A])
+        input.buttons |= INPUT_LEFT;
+    if (keystate[SDL_SCANCODE_D])
+        input.buttons |= INPUT_RIGHT;
+    if (keystate[SDL_SCANCODE_LEFT])
+        input.buttons |= INPUT_ROTATE_LEFT;
+    if (keystate[SDL_SCANCODE_RIGHT])
+        input.buttons |= INPUT_ROTATE_RIGHT;
+
+    return input;
+}
+
+/**
+ * Constructor for the RandomInput class.
+ *
+ * @param seed Seed for the random number generator.
+ */
+RandomInput::RandomInput(unsigned int seed)
+    : random(seed), current(InputState{0}), ticksLeft(0) {}
+
+/**
+ * Gets the bot's input for the next tick.
+ *
+ * @return The input for this tick.
+ */
+InputState RandomInput::poll() {
+    if (this->ticksLeft <= 0) {
+        // Mostly walk forward, turning and strafing now and then
+        const uint8_t choices[] = {
+            INPUT_FORWARD,
+            INPUT_FORWARD,
+            INPUT_FORWARD | INPUT_ROTATE_LEFT,
+            INPUT_FORWARD | INPUT_ROTATE_RIGHT,
+            INPUT_ROTATE_LEFT,
+            INPUT_ROTATE_RIGHT,
+            INPUT_LEFT,
+            INPUT_RIGHT,
+            INPUT_BACK,
+        };
+        int numChoices = sizeof(choices) / sizeof(choices[0]);
+
+        this->current.buttons = choices[this->random() % numChoices];
+        this->ticksLeft = 5 + this->random() % 40;
+    }
+
+    this->ticksLeft--;
+
+    return this->current;
+}
@@ -0,0 +1,242 @@
+// Jump Point Search for 4-connected, uniform-cost grids. Straight runs of
+// open tiles are skipped over instead of being expanded one tile at a time
+
+#include "Util/JumpPointSearch.hpp"
+#include "Maze/TileGrid.hpp"
+#include <cstdlib>
+
+/*
+ Among all shortest paths, the search only follows the canonical one that
+ moves horizontally as early as possible. A path moving vertically can only
+ turn sideways where the tile diagonally behind it is blocked (a forced
+ neighbour), because otherwise turning one row earlier is just as short.
+ Moving horizontally, every row is a potential turn, so each horizontal step
+ scans its column for jump points before the run continues.
+*/
+
+/**
+ * Constructor for the JumpPointSearch class. Its arrays are sized lazily by
+ * the first search.
+ *
+ * @param arena Arena to allocate the search's arrays from, or nullptr to use
+ * the heap.
+ */
+JumpPointSearch::JumpPointSearch(Arena *arena)
+    : map(nullptr), goal(-1), scores(arena), open(arena), expandedCount(0) {}
+
+/**
+ * Calculates the manhattan distance from a tile to the goal.
+ *
+ * @param tile Index of the tile.
+ * @return The heuristic value.
+ */
+int JumpPointSearch::heuristic(int tile) {
+    int width = this->map->getWidth();
+
+    return abs(tile % width - this->goal % width) +
+           abs(tile / width - this->goal / width);
+}
+
+/**
+ * Prepares the search arrays for a new search by advancing the generation
+ * counter so that old entries become stale.
+ *
+ * @param map The grid about to be searched.
+ * @param goal Index of the goal tile.
+ */
+void JumpPointSearch::reset(TileGrid *map, int goal) {
+    this->scores.reset(size_t(map->getWidth()) * map->getHeight());
+    this->map = map;
+    this->goal = goal;
+    this->open.clear();
+    this->expandedCount = 0;
+}
+
+/**
+ * Checks whether a tile can be walked on.
+ *
+ * @param x The x tile coordinate.
+ * @param y The y tile coordinate.
+ * @return True if the tile is inside the map and not a wall.
+ */
+bool JumpPointSearch::isOpen(int x, int y) { return !this->map->isWall(x, y); }
+
+/**
+ * Moves horizontally from a tile until reaching a jump point or a wall. A tile
+ * is a jump point if it is the goal or if a vertical jump from it finds one.
+ *
+ * @param x The x tile coordinate to jump from.
+ * @param y The y tile coordinate to jump from.
+ * @param dx The direction to move in, either -1 or 1.
+ * @return Index of the jump point, or -1 if a wall was hit first.
+ */
+int JumpPointSearch::jumpHorizontal(int x, int y, int dx) {
+    while (true) {
+        x += dx;
+
+        if (!this->isOpen(x, y))
+            return -1;
+
+        int tile = this->map->toIndex(x, y);
+
+        if (tile == this->goal || this->jumpVertical(x, y, -1) != -1 ||
+            this->jumpVertical(x, y, 1) != -1)
+            return tile;
+    }
+}
+
+/**
+ * Moves vertically from a tile until reaching a jump point or a wall. A tile
+ * is a jump point if it is the goal or has a forced neighbour: an open tile
+ * to its side whose own predecessor in the column is blocked.
+ *
+ * @param x The x tile coordinate to jump from.
+ * @param y The y tile coordinate to jump from.
+ * @param dy The direction to move in, either -1 or 1.
+ * @return Index of the jump point, or -1 if a wall was hit first.
+ */
+int JumpPointSearch::jumpVertical(int x, int y, int dy) {
+    while (true) {
+        y += dy;
+
+        if (!this->isOpen(x, y))
+            return -1;
+
+        int tile = this->map->toIndex(x, y);
+
+        if (tile == this->goal)
+            return tile;
+
+        if ((this->isOpen(x - 1, y) && !this->isOpen(x - 1, y - dy)) ||
+            (this->isOpen(x + 1, y) && !this->isOpen(x + 1, y - dy)))
+            return tile;
+    }
+}
+
+/**
+ * Queues a jump point reached in a straight line from the current one if that
+ * is the cheapest way found to it so far.
+ *
+ * @param current The jump point being expanded.
+ * @param successor Index of the jump point found, or -1 if there was none.
+ */
+void JumpPointSearch::addSuccessor(const OpenNode &current, int successor) {
+    if (successor == -1)
+        return;
+
+    int width = this->map->getWidth();
+    int distance = abs(successor % width - current.node % width) +
+                   abs(successor / width - current.node / width);
+    int tentativeGScore = current.gScore + distance;
+
+    // Tiles from an older generation have not been reached yet
+    if (this->scores.isVisited(successor) &&
+        this->scores[successor].gScore <= tentativeGScore)
+        return;
+
+    int h = this->heuristic(successor);
+
+    this->scores.visit(successor) = PathScore{tentativeGScore, current.node};
+    this->open.push(
+        OpenNode{tentativeGScore + h, h, tentativeGScore, successor});
+}
+
+/**
+ * Runs A* over jump points from the start tile until the goal is expanded.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid of walls to search.
+ * @return True if the goal was reached, false otherwise.
+ */
+bool JumpPointSearch::search(int start, int goal, TileGrid *map) {
+    this->reset(map, goal);
+
+    this->scores.visit(start) = PathScore{0, -1};
+
+    int startH = this->heuristic(start);
+    this->open.push(OpenNode{startH, startH, 0, start});
+
+    int width = map->getWidth();
+
+    while (!this->open.isEmpty()) {
+        OpenNode current = this->open.pop();
+
+        // Skip entries that were superseded by a cheaper path to the same tile
+        if (current.gScore != this->scores[current.node].gScore)
+            continue;
+
+        if (current.node == goal)
+            return true;
+
+        this->expandedCount++;
+
+        int x = current.node % width;
+        int y = current.node / width;
+        int from = this->scores[current.node].parent;
+
+        if (from == -1) {
+            // The start can be left in every direction
+            this->addSuccessor(current, this->jumpHorizontal(x, y, -1));
+            this->addSuccessor(current, this->jumpHorizontal(x, y, 1));
+            this->addSuccessor(current, this->jumpVertical(x, y, -1));
+            this->addSuccessor(current, this->jumpVertical(x, y, 1));
+        } else if (from / width == y) {
+            // Moving horizontally: keep going, or turn up or down
+            int dx = x > from % width ? 1 : -1;
+            this->addSuccessor(current, this->jumpHorizontal(x, y, dx));
+            this->addSuccessor(current, this->jumpVertical(x, y, -1));
+            this->addSuccessor(current, this->jumpVertical(x, y, 1));
+        } else {
+            // Moving vertically: keep going, or turn towards forced neighbours
+            int dy = y > from / width ? 1 : -1;
+            this->addSuccessor(current, this->jumpVertical(x, y, dy));
+
+            for (int dx = -1; dx <= 1; dx += 2) {
+                if (this->isOpen(x + dx, y) && !this->isOpen(x + dx, y - dy)) {
+                    this->addSuccessor(current,
+                                       this->jumpHorizontal(x, y, dx));
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Finds the tile to move to next in order to follow the shortest path from
+ * the start tile to the goal tile.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid of walls to search.
+ * @return Index of the tile adjacent to start on the path, or -1 if the goal
+ * is the start or cannot be reached.
+ */
+int JumpPointSearch::findNextStep(int start, int goal, TileGrid *map) {
+    if (start == goal || !this->search(start, goal, map))
+        return -1;
+
+    // Walk back to the first jump point after the start
+    int current = goal;
+    while (this->scores[current].parent != start) {
+        current = this->scores[current].parent;
+    }
+
+    // Jump points are reached in straight lines, so step towards it
+    int width = map->getWidth();
+    int startX = start % width, startY = start / width;
+    int jumpX = current % width, jumpY = current / width;
+    int dx = (jumpX > startX) - (jumpX < startX);
+    int dy = (jumpY > startY) - (jumpY < startY);
+
+    return map->toIndex(startX + dx, startY + dy);
+}
+
+/**
+ * Gets the number of jump points expanded by the most recent search.
+ *
+ * @return The number of expanded jump points.
+ */
+int JumpPointSearch::getExpandedCount() { return this->expandedCount; }
@@ -1,145 +1,175 @@
 // Pathfinding implementation with A*
 
 #include "Util/Pathfinding.hpp"
-#include "Maze/Tile.hpp"
-#include "Util/Constants.hpp"
-#include <cstdio>
-#include <iostream>
-#include <map>
-#include <queue>
-#include <tuple>
+#include "Maze/TileGrid.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
 #include <vector>
 
 // Direction vectors containing moves to explore all adjacent cells
 const int xDirections[] = {1, -1, 0, 0};
 const int yDirections[] = {0, 0, -1, 1};
 
+/**
+ * Constructor for the PathSearch class. Its arrays are sized lazily by the
+ * first search.
+ *
+ * @param arena Arena to allocate the search's arrays from, or nullptr to use
+ * the heap.
+ */
+PathSearch::PathSearch(Arena *arena)
+    : scores(arena), open(arena), expandedCount(0) {}
+
 /**
  * Calculates the heuristic value between two tiles for A* pathfinding.
  *
- * @param current The current tile.
- * @param goal The goal tile.
+ * @param current Index of the current tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid both tiles belong to.
  * @return The heuristic value.
  */
-int heuristic(Tile *current, Tile *goal) {
-    /*
-    Convert between pixel coordinates to tile coordinates. Each square tile
-    has a length of 16 pixels. Divide each pixel coordinate by 16 to obtain
-    the tile coordinate
-    */
-    int xCurr = int(current->getPosition()->x) / TILE_SIZE,
-        yCurr = int(current->getPosition()->y) / TILE_SIZE;
-
-    int xGoal = int(goal->getPosition()->x) / TILE_SIZE,
-        yGoal = int(goal->getPosition()->y) / TILE_SIZE;
+int PathSearch::heuristic(int current, int goal, TileGrid *map) {
+    // Convert from tile indices to tile coordinates
+    int xCurr = current % map->getWidth(), yCurr = current / map->getWidth();
+    int xGoal = goal % map->getWidth(), yGoal = goal / map->getWidth();
 
     // Calculate manhattan distance between current and goal
     return abs(xCurr - xGoal) + abs(yCurr - yGoal);
 }
 
 /**
- * Finds the path from the start tile to the goal tile on the given map using A*
- * algorithm.
+ * Prepares the search arrays for a new search. Instead of clearing every
+ * tile, the generation counter is advanced so that old entries become stale.
  *
- * @param start The starting tile.
- * @param goal The goal tile.
- * @param map The 2D vector representing the map of tiles.
- * @return A map of tiles representing the calculated path.
+ * @param map The grid about to be searched.
  */
-std::unordered_map<Tile *, Tile *>
-findPath(Tile *start, Tile *goal, std::vector<std::vector<Tile>> *map) {
-
-    // Initialize the gScore and fScore maps. Each tile should have an initial
-    // cost of infinity
-    std::unordered_map<Tile *, int> gScore;
-    for (int i = 0; i < MAP_SIZE; i++) {
-        for (int j = 0; j < MAP_SIZE; j++) {
-            gScore[&(*map)[i][j]] = INFINITY;
-        }
-    }
-    gScore[start] = 0; // Score of the starting tile is 0
-
-    std::unordered_map<Tile *, int> fScore;
-    for (int i = 0; i < MAP_SIZE; i++) {
-        for (int j = 0; j < MAP_SIZE; j++) {
-            fScore[&(*map)[i][j]] = INFINITY;
-        }
-    }
-    fScore[start] = heuristic(start, goal);
+void PathSearch::reset(TileGrid *map) {
+    this->scores.reset(size_t(map->getWidth()) * map->getHeight());
+    this->open.clear();
+    this->expandedCount = 0;
+}
 
-    // Priority queue sorted by fScore in increasing order. Each element in the
-    // queue is a tuple containing the fScore, heuristic, and corresponding Tile
-    std::priority_queue<std::tuple<int, int, Tile *>,
-                        std::vector<std::tuple<int, int, Tile *>>,
-                        std::greater<std::tuple<int, int, Tile *>>>
-        open;
+/**
+ * Runs A* from the start tile until the goal tile is expanded.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid of walls to search.
+ * @return True if the goal was reached, false otherwise.
+ */
+bool PathSearch::search(int start, int goal, TileGrid *map) {
+    this->reset(map);
 
-    open.push({fScore[start], heuristic(start, goal), start});
+    this->scores.visit(start) = PathScore{0, -1}; // Score of the start is 0
 
-    // Map to store the optimal path
-    std::unordered_map<Tile *, Tile *> cameFrom;
+    int startH = this->heuristic(start, goal, map);
+    this->open.push(OpenNode{startH, startH, 0, start});
 
     // A* algorithm main loop
-    while (!open.empty()) {
-        Tile *current = std::get<2>(open.top());
-        open.pop();
+    while (!this->open.isEmpty()) {
+        OpenNode current = this->open.pop();
+
+        // Skip entries that were superseded by a cheaper path to the same tile
+        if (current.gScore != this->scores[current.node].gScore)
+            continue;
 
         // Goal reached, exit loop
-        if (current == goal) {
-            break;
-        }
+        if (current.node == goal)
+            return true;
+
+        this->expandedCount++;
+
+        // Convert from the tile index to tile coordinates
+        int xCurr = current.node % map->getWidth(),
+            yCurr = current.node / map->getWidth();
 
         // Explore neighbors
         for (int i = 0; i < 4; i++) {
-            // Once again, divide by the tile size to go from pixel coordinates
-            // to tile coordinates
-            int xCurr = int(current->getPosition()->x) / TILE_SIZE,
-                yCurr = int(current->getPosition()->y) / TILE_SIZE;
-
             // Move to an adjacent cell using the direction vectors
             int xNew = xCurr + xDirections[i], yNew = yCurr + yDirections[i];
 
-            Tile *neighbor = nullptr;
+            // Skip the neighbor if it is out of bounds or a wall
+            if (map->isWall(xNew, yNew))
+                continue;
 
-            // Check if the neighbor is within bounds and not a wall
-            if (xNew >= 0 && xNew < MAP_SIZE && yNew >= 0 && yNew < MAP_SIZE &&
-                !(*map)[yNew][xNew].getIsWall()) {
-                neighbor = &(*map)[yNew][xNew];
-            }
+            int neighbor = map->toIndex(xNew, yNew);
 
-            if (neighbor == nullptr) {
-                continue;
-            }
+            // The gScore increases by 1 each move. Tiles from an older
+            // generation have not been reached yet and cost infinity
+            int tentativeGScore = current.gScore + 1;
+            int neighborGScore = this->scores.isVisited(neighbor)
+                                     ? this->scores[neighbor].gScore
+                                     : INT_MAX;
+
+            // Put neighbour on the open list if it's gained a better gScore
+            if (tentativeGScore < neighborGScore) {
+                int h = this->heuristic(neighbor, goal, map);
 
-            /*
-            Calculate gScore and fScore for the neighbor
-
-            The gScore (essentially the distance from the starting
-            position) increases by 1 each move. The heuristic is the distance
-            from a tile to the goal
-            */
-            int tentativeGScore = gScore[current] + 1;
-            int tentativeFScore = tentativeGScore + heuristic(neighbor, goal);
-
-            // Put neighbour on priority queue if it's gained a better fScore
-            if (tentativeFScore < fScore[neighbor]) {
-                gScore[neighbor] = tentativeGScore;
-                fScore[neighbor] = tentativeFScore;
-                open.push(
-                    {fScore[neighbor], heuristic(neighbor, goal), neighbor});
-                cameFrom[neighbor] = current;
+                this->scores.visit(neighbor) =
+                    PathScore{tentativeGScore, current.node};
+                this->open.push(OpenNode{tentativeGScore + h, h,
+                                         tentativeGScore, neighbor});
             }
         }
     }
 
-    // Reconstruct the path from goal to start
-    std::unordered_map<Tile *, Tile *> path;
-    Tile *current = goal;
+    return false;
+}
+
+/**
+ * Finds the tile to move to next in order to follow the shortest path from
+ * the start tile to the goal tile.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid of walls to search.
+ * @return Index of the tile adjacent to start on the path, or -1 if the goal
+ * is the start or cannot be reached.
+ */
+int PathSearch::findNextStep(int start, int goal, TileGrid *map) {
+    if (start == goal || !this->search(start, goal, map))
+        return -1;
+
+    // Walk back from the goal until reaching the tile right after the start
+    int current = goal;
+    while (this->scores[current].parent != start) {
+        current = this->scores[current].parent;
+    }
+
+    return current;
+}
+
+/**
+ * Finds the full shortest path from the start tile to the goal tile.
+ *
+ * @param start Index of the starting tile.
+ * @param goal Index of the goal tile.
+ * @param map The grid of walls to search.
+ * @param path Filled with the tiles of the path in order, excluding the start
+ * and including the goal.
+ * @return True if the goal was reached, false otherwise.
+ */
+bool PathSearch::findPath(int start, int goal, TileGrid *map,
+                          std::vector<int> *path) {
+    path->clear();
 
-    while (current != start) {
-        path[cameFrom[current]] = current;
-        current = cameFrom[current];
+    if (!this->search(start, goal, map))
+        return false;
+
+    // Reconstruct the path from goal to start, then put it in walking order
+    for (int current = goal; current != start;
+         current = this->scores[current].parent) {
+        path->push_back(current);
     }
+    std::reverse(path->begin(), path->end());
 
-    return path;
+    return true;
 }
+
+/**
+ * Gets the number of tiles expanded by the most recent search.
+ *
+ * @return The number of expanded tiles.
+ */
+int PathSearch::getExpandedCount() { return this->expandedCount; }
@@ -0,0 +1,286 @@
+// Frame profiler timing named scopes of the game, such as a frame's update and
+// render. Each thread records the scopes it finishes into its own ring buffer,
+// which the on-screen overlay summarizes and which can be written out as a
+// Chrome trace_event file. Unless the game is built with PROFILING defined, as
+// `make profile` does, the markers compile to nothing
+
+#include "Util/Profiler.hpp"
+
+#ifdef PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// The events recorded by one thread. Only that thread writes to it; other
+// threads read it while it is being written, and throw away whatever may have
+// been overwritten while they were reading
+struct ProfileBuffer {
+    ProfileEvent events[Profiler::BUFFER_SIZE];
+
+    // Number of events ever recorded. The newest is at (count - 1) modulo
+    // BUFFER_SIZE
+    std::atomic<uint64_t> count;
+
+    // Number the thread is shown as, in the order threads first recorded
+    int threadId;
+
+    // Name the thread is shown as, or nullptr to show its number
+    const char *threadName;
+};
+
+// Every thread's buffer. Buffers are kept for as long as the program runs, so
+// the events of threads that have finished can still be read
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+
+    // Time every timestamp is measured from
+    std::chrono::steady_clock::time_point epoch;
+};
+
+/**
+ * Gets the registry of buffers, creating it on first use.
+ *
+ * @return The registry.
+ */
+ProfileRegistry *getProfileRegistry() {
+    static ProfileRegistry registry{{}, {}, std::chrono::steady_clock::now()};
+    return &registry;
+}
+
+// The calling thread's buffer, created the first time it records an event
+thread_local ProfileBuffer *threadBuffer = nullptr;
+
+/**
+ * Gets the calling thread's buffer, creating it on first use.
+ *
+ * @return The buffer.
+ */
+ProfileBuffer *getThreadBuffer() {
+    if (threadBuffer != nullptr)
+        return threadBuffer;
+
+    ProfileRegistry *registry = getProfileRegistry();
+    std::lock_guard<std::mutex> lock(registry->mutex);
+
+    std::unique_ptr<ProfileBuffer> buffer = std::make_unique<ProfileBuffer>();
+    buffer->count.store(0);
+    buffer->threadId = registry->buffers.size() + 1;
+    buffer->threadName = nullptr;
+
+    threadBuffer = buffer.get();
+    registry->buffers.push_back(std::move(buffer));
+
+    return threadBuffer;
+}
+
+/**
+ * Copies the events a buffer still holds, oldest first, leaving out any that
+ * its thread overwrote or may have been overwriting during the copy.
+ *
+ * @param buffer The buffer to read.
+ * @param events The vector to append the events to.
+ */
+void readBuffer(ProfileBuffer *buffer, std::vector<ProfileEvent> *events) {
+    uint64_t end = buffer->count.load(std::memory_order_acquire);
+    uint64_t begin = end > Profiler::BUFFER_SIZE ? end - Profiler::BUFFER_SIZE
+                                                 : 0;
+
+    size_t first = events->size();
+    for (uint64_t i = begin; i < end; i++) {
+        events->push_back(buffer->events[i % Profiler::BUFFER_SIZE]);
+    }
+
+    // Events older than this were overwritten while they were being copied.
+    // The thread writes an event into its slot before counting it, so the
+    // slot of the next event, which holds the oldest one kept, may be half
+    // written too. The fence keeps the copy from being read after the count
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = buffer->count.load(std::memory_order_acquire);
+    uint64_t overwritten = after + 1 > Profiler::BUFFER_SIZE
+                               ? after + 1 - Profiler::BUFFER_SIZE
+                               : 0;
+
+    if (overwritten > begin) {
+        size_t count = std::min<uint64_t>(overwritten - begin, end - begin);
+        events->erase(events->begin() + first,
+                      events->begin() + first + count);
+    }
+}
+
+/**
+ * Gets the time since the profiler started.
+ *
+ * @return The time in nanoseconds.
+ */
+int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() -
+               getProfileRegistry()->epoch)
+        .count();
+}
+
+/**
+ * Records a scope that has finished on the calling thread, overwriting the
+ * thread's oldest event once its buffer is full.
+ *
+ * @param name Name the scope was marked with, which must be a string literal.
+ * @param start When the scope was entered, from Profiler::now.
+ * @param end When the scope was left, from Profiler::now.
+ */
+void Profiler::record(const char *name, int64_t start, int64_t end) {
+    ProfileBuffer *buffer = getThreadBuffer();
+    uint64_t count = buffer->count.load(std::memory_order_relaxed);
+
+    // Readers rely on a slot only being overwritten once the event before it
+    // has been counted, so the count must be seen before the new event
+    std::atomic_thread_fence(std::memory_order_release);
+
+    buffer->events[count % BUFFER_SIZE] =
+        ProfileEvent{name, start, end - start};
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+/**
+ * Names the calling thread in traces.
+ *
+ * @param name The thread's name, which must be a string literal.
+ */
+void Profiler::setThreadName(const char *name) {
+    ProfileBuffer *buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(getProfileRegistry()->mutex);
+    buffer->threadName = name;
+}
+
+/**
+ * Sums up how long each named scope took across every thread, ordered by
+ * name. Scopes from different places with the same name are counted together.
+ *
+ * @param since Only scopes entered at or after this time are counted, from
+ * Profiler::now.
+ * @param stats The vector to fill, emptied first.
+ */
+void Profiler::getStats(int64_t since, std::vector<ProfileStats> *stats) {
+    std::vector<ProfileEvent> events;
+
+    ProfileRegistry *registry = getProfileRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        for (const std::unique_ptr<ProfileBuffer> &buffer : registry->buffers) {
+            readBuffer(buffer.get(), &events);
+        }
+    }
+
+    stats->clear();
+
+    for (const ProfileEvent &event : events) {
+        if (event.start < since)
+            continue;
+
+        auto it = std::find_if(stats->begin(), stats->end(),
+                               [&event](const ProfileStats &entry) {
+                                   return strcmp(entry.name, event.name) == 0;
+                               });
+
+        if (it == stats->end()) {
+            stats->push_back(ProfileStats{event.name, 0, 0, 0});
+            it = stats->end() - 1;
+        }
+
+        it->count++;
+        it->total += event.duration;
+        it->max = std::max(it->max, event.duration);
+    }
+
+    std::sort(stats->begin(), stats->end(),
+              [](const ProfileStats &a, const ProfileStats &b) {
+                  return strcmp(a.name, b.name) < 0;
+              });
+}
+
+/**
+ * Writes a string as a JSON string literal.
+ *
+ * @param file The file to write to.
+ * @param text The string to write.
+ */
+void writeJsonString(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+/**
+ * Writes every event still held by any thread to a file in Chrome's
+ * trace_event format, which chrome://tracing and Perfetto can open.
+ *
+ * @param filePath The path to write the trace to.
+ * @return False if the file could not be written.
+ */
+bool Profiler::writeTrace(const char *filePath) {
+    FILE *file = fopen(filePath, "w");
+    if (file == NULL) {
+        std::cout << "FAILED TO WRITE TRACE " << filePath << "\n";
+        return false;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    bool isFirst = true;
+
+    ProfileRegistry *registry = getProfileRegistry();
+    std::lock_guard<std::mutex> lock(registry->mutex);
+
+    std::vector<ProfileEvent> events;
+    for (const std::unique_ptr<ProfileBuffer> &buffer : registry->buffers) {
+        if (buffer->threadName != nullptr) {
+            fprintf(file,
+                    "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                    "\"tid\":%d,\"args\":{\"name\":",
+                    isFirst ? "" : ",", buffer->threadId);
+            writeJsonString(file, buffer->threadName);
+            fputs("}}", file);
+            isFirst = false;
+        }
+
+        events.clear();
+        readBuffer(buffer.get(), &events);
+
+        // Complete events, with timestamps in microseconds
+        for (const ProfileEvent &event : events) {
+            fprintf(file, "%s\n{\"name\":", isFirst ? "" : ",");
+            writeJsonString(file, event.name);
+            fprintf(file,
+                    ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,"
+                    "\"dur\":%.3f}",
+                    buffer->threadId, event.start / 1000.0,
+                    event.duration / 1000.0);
+            isFirst = false;
+        }
+    }
+
+    fputs("\n]}\n", file);
+
+    bool isWritten = ferror(file) == 0;
+    if (fclose(file) != 0 || !isWritten) {
+        std::cout << "FAILED TO WRITE TRACE " << filePath << "\n";
+        return false;
+    }
+
+    std::cout << "wrote trace " << filePath << "\n";
+    return true;
+}
+
+#endif
@@ -0,0 +1,36 @@
+// Initializes SDL, SDL Image and SDL TTF for as long as it exists, and shuts
+// SDL down when it is destroyed. Anything holding SDL resources must be
+// destroyed first, so it belongs after the context in its owner
+
+#include "Util/SdlContext.hpp"
+#include "Util/FontCache.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+
+/**
+ * Initialize SDL, SDL Image, and SDL TTF.
+ */
+SdlContext::SdlContext() {
+    if (SDL_Init(SDL_INIT_VIDEO) != 0)
+        std::cout << "SDL_Init HAS FAILED. SDL_ERROR: " << SDL_GetError()
+                  << "\n";
+
+    if (!IMG_Init(IMG_INIT_PNG))
+        std::cout << "IMG_Init HAS FAILED. SDL_ERROR: " << SDL_GetError()
+                  << "\n";
+
+    if (TTF_Init() != 0) {
+        std::cout << "TTF_Init HAS FAILED. SDL_ERROR: " << SDL_GetError()
+                  << "\n";
+    }
+}
+
+/**
+ * Shut SDL down, once the fonts it opened are closed.
+ */
+SdlContext::~SdlContext() {
+    FontCache::clear();
+    SDL_Quit();
+}
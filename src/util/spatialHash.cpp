@@ -0,0 +1,179 @@
+// Uniform grid of cells over a level, bucketing entities by where they are so
+// that finding the entities touching a box only looks at the cells around it.
+// Levels are bounded, so cells are indexed directly rather than hashed
+
+#include "Util/SpatialHash.hpp"
+#include "Util/Arena.hpp"
+#include <algorithm>
+
+/**
+ * Constructor for an empty SpatialHash covering a single cell.
+ *
+ * @param arena Arena to allocate the cells and entities from, or nullptr to
+ * use the heap.
+ */
+SpatialHash::SpatialHash(Arena *arena)
+    : columns(1), rows(1), cells(1, -1, ArenaAllocator<int>(arena)),
+      items(ArenaAllocator<Item>(arena)) {}
+
+/**
+ * Sets the area covered by the cells, removing every entity. Entities outside
+ * of the area are kept in the nearest cell along its edge.
+ *
+ * @param width Width of the area in pixels.
+ * @param height Height of the area in pixels.
+ */
+void SpatialHash::setBounds(int width, int height) {
+    this->columns = std::max((width + CELL_SIZE - 1) / CELL_SIZE, 1);
+    this->rows = std::max((height + CELL_SIZE - 1) / CELL_SIZE, 1);
+
+    this->cells.assign(this->columns * this->rows, -1);
+    this->items.clear();
+}
+
+/**
+ * Gets the column of cells a position falls in.
+ *
+ * @param x The x-coordinate.
+ * @return The column, clamped to the grid.
+ */
+int SpatialHash::getColumn(float x) {
+    return std::max(0, std::min(int(x) / CELL_SIZE, this->columns - 1));
+}
+
+/**
+ * Gets the row of cells a position falls in.
+ *
+ * @param y The y-coordinate.
+ * @return The row, clamped to the grid.
+ */
+int SpatialHash::getRow(float y) {
+    return std::max(0, std::min(int(y) / CELL_SIZE, this->rows - 1));
+}
+
+/**
+ * Adds an entity to the front of a cell's list.
+ *
+ * @param id Id of the entity.
+ * @param cell Index of the cell.
+ */
+void SpatialHash::link(int id, int cell) {
+    Item &item = this->items[id];
+    item.cell = cell;
+    item.previous = -1;
+    item.next = this->cells[cell];
+
+    if (item.next != -1) {
+        this->items[item.next].previous = id;
+    }
+    this->cells[cell] = id;
+}
+
+/**
+ * Takes an entity out of its cell's list.
+ *
+ * @param id Id of the entity.
+ */
+void SpatialHash::unlink(int id) {
+    Item &item = this->items[id];
+
+    if (item.previous != -1) {
+        this->items[item.previous].next = item.next;
+    } else {
+        this->cells[item.cell] = item.next;
+    }
+
+    if (item.next != -1) {
+        this->items[item.next].previous = item.previous;
+    }
+
+    item.cell = -1;
+}
+
+/**
+ * Adds an entity, filed under the cell holding its top-left corner. Ids are
+ * chosen by the caller and index an array, so they should be small and dense.
+ *
+ * @param id Id of the entity, which must not already be in use.
+ * @param x The x-coordinate of the entity's bounding box.
+ * @param y The y-coordinate of the entity's bounding box.
+ * @param width The width of the box, no larger than a cell.
+ * @param height The height of the box, no larger than a cell.
+ */
+void SpatialHash::insert(int id, float x, float y, float width,
+                         float height) {
+    if (id >= (int)this->items.size()) {
+        this->items.resize(id + 1, Item{0, 0, 0, 0, -1, -1, -1});
+    }
+
+    Item &item = this->items[id];
+    item.x = x;
+    item.y = y;
+    item.width = width;
+    item.height = height;
+
+    this->link(id, this->getRow(y) * this->columns + this->getColumn(x));
+}
+
+/**
+ * Moves an entity, changing its cell only if it crossed into another one.
+ *
+ * @param id Id of the entity.
+ * @param x The new x-coordinate of the entity's bounding box.
+ * @param y The new y-coordinate of the entity's bounding box.
+ */
+void SpatialHash::move(int id, float x, float y) {
+    Item &item = this->items[id];
+    item.x = x;
+    item.y = y;
+
+    int cell = this->getRow(y) * this->columns + this->getColumn(x);
+    if (cell != item.cell) {
+        this->unlink(id);
+        this->link(id, cell);
+    }
+}
+
+/**
+ * Removes an entity. Its id may be used again afterwards.
+ *
+ * @param id Id of the entity.
+ */
+void SpatialHash::remove(int id) { this->unlink(id); }
+
+/**
+ * Finds every entity whose bounding box overlaps a box. Boxes that only touch
+ * along an edge do not overlap. Entities are filed by their top-left corner
+ * and are no larger than a cell, so the cells searched start one cell above
+ * and to the left of the box.
+ *
+ * @param x The x-coordinate of the box.
+ * @param y The y-coordinate of the box.
+ * @param width The width of the box.
+ * @param height The height of the box.
+ * @param results The vector to append the ids of the overlapping entities to.
+ */
+void SpatialHash::query(float x, float y, float width, float height,
+                        ArenaVector<int> *results) {
+    int minColumn = this->getColumn(x - CELL_SIZE);
+    int maxColumn = this->getColumn(x + width);
+    int minRow = this->getRow(y - CELL_SIZE);
+    int maxRow = this->getRow(y + height);
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int column = minColumn; column <= maxColumn; column++) {
+            int id = this->cells[row * this->columns + column];
+
+            while (id != -1) {
+                const Item &item = this->items[id];
+
+                if (item.y + item.height > y && item.y < y + height &&
+                    item.x + item.width > x && item.x < x + width) {
+                    results->push_back(id);
+                }
+
+                id = item.next;
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+// Collects the sprites drawn during a frame and submits them together. Sprites
+// are grouped by layer and texture, and every group is drawn with a single
+// SDL_RenderGeometry call
+
+#include "Util/SpriteBatch.hpp"
+#include <algorithm>
+
+/**
+ * Constructor for an empty SpriteBatch.
+ */
+SpriteBatch::SpriteBatch() : drawCallCount(0) {}
+
+/**
+ * Orders quads by layer, then by texture, then by the order they were drawn.
+ *
+ * @param a The first quad.
+ * @param b The second quad.
+ * @return True if a should be drawn before b.
+ */
+bool SpriteBatch::isBefore(const Quad &a, const Quad &b) {
+    if (a.layer != b.layer)
+        return a.layer < b.layer;
+    if (a.texture != b.texture)
+        return a.texture < b.texture;
+    return a.order < b.order;
+}
+
+/**
+ * Queues part of a texture to be drawn when the batch is next flushed.
+ * Sprites on higher layers are drawn over sprites on lower ones.
+ *
+ * @param texture The texture to draw from.
+ * @param src The rectangle of the texture to draw.
+ * @param dst The rectangle of the screen to draw it to.
+ * @param layer The layer to draw the sprite on.
+ */
+void SpriteBatch::draw(SDL_Texture *texture, const SDL_Rect &src,
+                       const SDL_Rect &dst, int layer) {
+    if (texture == NULL)
+        return;
+
+    this->quads.push_back(
+        Quad{layer, texture, src, dst, uint32_t(this->quads.size())});
+}
+
+/**
+ * Draws a run of quads sharing one texture with a single call.
+ *
+ * @param renderer The renderer to draw with.
+ * @param start The index of the first quad of the run.
+ * @param end The index one past the last quad of the run.
+ */
+void SpriteBatch::submitGroup(SDL_Renderer *renderer, int start, int end) {
+    SDL_Texture *texture = this->quads[start].texture;
+
+    int textureWidth, textureHeight;
+    SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
+
+    float scaleX = 1.0f / textureWidth;
+    float scaleY = 1.0f / textureHeight;
+    SDL_Color white = {255, 255, 255, 255};
+
+    this->vertices.clear();
+    this->indices.clear();
+
+    for (int i = start; i < end; i++) {
+        const Quad &quad = this->quads[i];
+
+        float left = quad.dst.x;
+        float top = quad.dst.y;
+        float right = quad.dst.x + quad.dst.w;
+        float bottom = quad.dst.y + quad.dst.h;
+
+        float u0 = quad.src.x * scaleX;
+        float v0 = quad.src.y * scaleY;
+        float u1 = (quad.src.x + quad.src.w) * scaleX;
+        float v1 = (quad.src.y + quad.src.h) * scaleY;
+
+        int first = this->vertices.size();
+        this->vertices.push_back(SDL_Vertex{{left, top}, white, {u0, v0}});
+        this->vertices.push_back(SDL_Vertex{{right, top}, white, {u1, v0}});
+        this->vertices.push_back(SDL_Vertex{{right, bottom}, white, {u1, v1}});
+        this->vertices.push_back(SDL_Vertex{{left, bottom}, white, {u0, v1}});
+
+        const int corners[] = {0, 1, 2, 0, 2, 3};
+        for (int corner : corners) {
+            this->indices.push_back(first + corner);
+        }
+    }
+
+    this->drawCallCount++;
+
+    if (SDL_RenderGeometry(renderer, texture, this->vertices.data(),
+                           this->vertices.size(), this->indices.data(),
+                           this->indices.size()) == 0) {
+        return;
+    }
+
+    // Renderers without geometry support draw the sprites one by one
+    for (int i = start; i < end; i++) {
+        SDL_RenderCopy(renderer, texture, &this->quads[i].src,
+                       &this->quads[i].dst);
+    }
+    this->drawCallCount += end - start;
+}
+
+/**
+ * Draws every queued sprite and empties the batch. Anything drawn straight
+ * to the renderer before the flush ends up underneath the batched sprites.
+ *
+ * @param renderer The renderer to draw with.
+ */
+void SpriteBatch::flush(SDL_Renderer *renderer) {
+    this->drawCallCount = 0;
+
+    std::sort(this->quads.begin(), this->quads.end(), isBefore);
+
+    int start = 0;
+    for (int i = 1; i <= (int)this->quads.size(); i++) {
+        if (i == (int)this->quads.size() ||
+            this->quads[i].layer != this->quads[start].layer ||
+            this->quads[i].texture != this->quads[start].texture) {
+            this->submitGroup(renderer, start, i);
+            start = i;
+        }
+    }
+
+    this->quads.clear();
+}
+
+/**
+ * Gets the number of draw calls made by the most recent flush.
+ *
+ * @return The number of draw calls.
+ */
+int SpriteBatch::getDrawCallCount() { return this->drawCallCount; }
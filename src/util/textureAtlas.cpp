@@ -0,0 +1,155 @@
+// Packs several small images into a single texture so that sprites sharing it
+// can be drawn from one GPU resource using per-sprite source rectangles
+
+#include "Util/TextureAtlas.hpp"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <iostream>
+
+// Empty pixels left around every image so that neighbouring images never bleed
+// into each other when sampled
+const int ATLAS_PADDING = 1;
+
+/**
+ * Constructor for the TextureAtlas class. The atlas is empty until build() is
+ * called.
+ */
+TextureAtlas::TextureAtlas() : texture(NULL) {}
+
+/**
+ * Decodes every image once, packs them into rows ("shelves") of a single
+ * surface and uploads the result as one texture.
+ *
+ * @param renderer The renderer that will own the atlas texture.
+ * @param files Paths of the images to pack.
+ * @return True if every image was packed, false otherwise.
+ */
+bool TextureAtlas::build(SDL_Renderer *renderer,
+                         const std::vector<const char *> &files) {
+    this->destroy();
+
+    std::vector<SDL_Surface *> surfaces;
+    std::vector<const char *> packedFiles;
+    std::vector<int> order;
+    int atlasWidth = 0;
+
+    // Decode every image and find the widest one, which sets the atlas width
+    for (const char *file : files) {
+        SDL_Surface *surface = IMG_Load(file);
+
+        if (surface == NULL) {
+            std::cout << "FAILED TO LOAD ATLAS IMAGE. SDL_ERROR: "
+                      << SDL_GetError() << "\n";
+            continue;
+        }
+
+        order.push_back(surfaces.size());
+        surfaces.push_back(surface);
+        packedFiles.push_back(file);
+        atlasWidth = std::max(atlasWidth, surface->w + 2 * ATLAS_PADDING);
+    }
+
+    // Pack the tallest images first so that each shelf wastes little space
+    std::sort(order.begin(), order.end(), [&surfaces](int a, int b) {
+        return surfaces[a]->h > surfaces[b]->h;
+    });
+
+    std::vector<SDL_Rect> rects(surfaces.size());
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (int i : order) {
+        int width = surfaces[i]->w + 2 * ATLAS_PADDING;
+        int height = surfaces[i]->h + 2 * ATLAS_PADDING;
+
+        // Start a new shelf once the current one is full
+        if (shelfX + width > atlasWidth) {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+
+        rects[i] = SDL_Rect{shelfX + ATLAS_PADDING, shelfY + ATLAS_PADDING,
+                            surfaces[i]->w, surfaces[i]->h};
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+
+    int atlasHeight = shelfY + shelfHeight;
+    bool success = atlasWidth > 0 && surfaces.size() == files.size();
+
+    if (atlasWidth > 0) {
+        SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(
+            0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+
+        // Copy pixels verbatim, including their alpha, instead of blending
+        for (int i = 0; i < (int)surfaces.size(); i++) {
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], NULL, atlasSurface, &rects[i]);
+        }
+
+        this->texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+        SDL_FreeSurface(atlasSurface);
+
+        if (this->texture == NULL) {
+            std::cout << "FAILED TO CREATE ATLAS. SDL_ERROR: " << SDL_GetError()
+                      << "\n";
+            success = false;
+        } else {
+            SDL_SetTextureBlendMode(this->texture, SDL_BLENDMODE_BLEND);
+        }
+    }
+
+    // Record where each image ended up. Images that failed to decode are left
+    // out so that callers fall back to loading them on their own
+    if (this->texture != NULL) {
+        for (int i = 0; i < (int)packedFiles.size(); i++) {
+            this->regions[packedFiles[i]] = rects[i];
+        }
+    }
+
+    for (SDL_Surface *surface : surfaces) {
+        SDL_FreeSurface(surface);
+    }
+
+    return success;
+}
+
+/**
+ * Checks whether the atlas texture has been created.
+ *
+ * @return True if build() has produced a texture, false otherwise.
+ */
+bool TextureAtlas::isBuilt() { return this->texture != NULL; }
+
+/**
+ * Looks up where an image was packed within the atlas.
+ *
+ * @param filePath The path the image was packed from.
+ * @param region Filled with the atlas texture and the image's rectangle.
+ * @return True if the image is part of the atlas, false otherwise.
+ */
+bool TextureAtlas::getRegion(const char *filePath, TextureRegion *region) {
+    auto it = this->regions.find(filePath);
+
+    if (this->texture == NULL || it == this->regions.end()) {
+        return false;
+    }
+
+    region->texture = this->texture;
+    region->rect = it->second;
+    return true;
+}
+
+/**
+ * Frees the atlas texture and forgets every packed region.
+ */
+void TextureAtlas::destroy() {
+    if (this->texture != NULL) {
+        SDL_DestroyTexture(this->texture);
+        this->texture = NULL;
+    }
+
+    this->regions.clear();
+}
@@ -0,0 +1,139 @@
+// Worker threads kept for the whole run of the game, which the iterations of a
+// loop can be spread across. The threads are started once, so handing them a
+// loop costs waking them up rather than starting new threads
+
+#include "Util/ThreadPool.hpp"
+#include "Util/Profiler.hpp"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Constructor for the ThreadPool class, starting its workers.
+ *
+ * @param numWorkers Number of threads to start. With none, loops run entirely
+ * on the thread that starts them.
+ */
+ThreadPool::ThreadPool(int numWorkers)
+    : task(nullptr), taskCount(0), nextIndex(0), activeWorkers(0),
+      generation(0), isStopping(false) {
+    for (int i = 0; i < numWorkers; i++) {
+        this->workers.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+/**
+ * Claims and runs iterations of the current loop until none are left.
+ */
+void ThreadPool::runTasks() {
+    int index;
+    while ((index = this->nextIndex.fetch_add(1)) < this->taskCount) {
+        (*this->task)(index);
+    }
+}
+
+/**
+ * Runs a share of every loop started until the pool is destroyed.
+ */
+void ThreadPool::run() {
+    PROFILE_THREAD_NAME("ThreadPool");
+
+    // Workers start before any loop does, but may only get to run after the
+    // first loops have started, so they count from the pool's first generation
+    // rather than the current one
+    uint64_t seenGeneration = 0;
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (true) {
+        this->workReady.wait(lock, [this, seenGeneration]() {
+            return this->isStopping || this->generation != seenGeneration;
+        });
+
+        if (this->isStopping)
+            return;
+
+        seenGeneration = this->generation;
+
+        lock.unlock();
+        this->runTasks();
+        lock.lock();
+
+        this->activeWorkers--;
+        if (this->activeWorkers == 0) {
+            this->workDone.notify_one();
+        }
+    }
+}
+
+/**
+ * Gets the number of threads a loop is spread across, counting the one that
+ * starts it.
+ *
+ * @return The number of threads.
+ */
+int ThreadPool::getThreadCount() const { return this->workers.size() + 1; }
+
+/**
+ * Runs every iteration of a loop across the workers and the calling thread,
+ * returning once all of them have finished. Iterations run in no particular
+ * order, so they must not depend on one another. Only one thread may start
+ * loops at a time.
+ *
+ * @param count Number of iterations.
+ * @param task Body of the loop, called with the index of each iteration.
+ */
+void ThreadPool::parallelFor(int count,
+                             const std::function<void(int)> &task) {
+    if (this->workers.empty() || count <= 1) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &task;
+        this->taskCount = count;
+        this->nextIndex = 0;
+        this->activeWorkers = this->workers.size();
+        this->generation++;
+    }
+    this->workReady.notify_all();
+
+    this->runTasks();
+
+    // The loop's body and count must stay put until every worker is done
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->workDone.wait(lock, [this]() { return this->activeWorkers == 0; });
+    this->task = nullptr;
+}
+
+/**
+ * Gets the pool shared by the whole game, starting it on first use with a
+ * worker for every core besides the calling thread's.
+ *
+ * @return The shared pool.
+ */
+ThreadPool *ThreadPool::getShared() {
+    static ThreadPool pool(
+        std::max(int(std::thread::hardware_concurrency()) - 1, 0));
+    return &pool;
+}
+
+/**
+ * Destructor for the ThreadPool class, waiting for its workers to exit.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->isStopping = true;
+    }
+    this->workReady.notify_all();
+
+    for (std::thread &worker : this->workers) {
+        worker.join();
+    }
+}
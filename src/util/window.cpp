@@ -2,13 +2,22 @@
 // the screen
 
 #include "Util/Window.hpp"
+#include "Util/Constants.hpp"
 #include <iostream>
 
+// Images packed into the sprite atlas the first time a sprite is loaded
+const std::vector<const char *> ATLAS_SPRITES = {
+    "res/img/Key.png",         "res/img/MapGridCell.png",
+    "res/img/MapPlayer16.png", "res/img/MapWall16.png",
+    "res/img/Steven.png",
+};
+
 /**
  * The Window class constructor
  */
 Window::Window(const char *title, int width, int height)
-    : sdlWindow(NULL), renderer(NULL) {
+    : sdlWindow(NULL), renderer(NULL), isAtlasAttempted(false), width(width),
+      height(height), camera(SDL_Point{0, 0}), interpolation(1) {
     /**
      * Creates an SDL window with the specified title, width, and height.
      *
@@ -54,13 +63,78 @@ Window::Window(const char *title, int width, int height)
 SDL_Renderer *Window::getRenderer() { return this->renderer; }
 
 /**
- * Loads an SDL texture from a specified file path.
+ * Gets the batch sprites are drawn through during the frame.
+ *
+ * @return The sprite batch.
+ */
+SpriteBatch *Window::getSpriteBatch() { return &this->spriteBatch; }
+
+/**
+ * Gets the width of the window.
+ *
+ * @return The width in pixels.
+ */
+int Window::getWidth() { return this->width; }
+
+/**
+ * Gets the height of the window.
+ *
+ * @return The height in pixels.
+ */
+int Window::getHeight() { return this->height; }
+
+/**
+ * Moves the camera, scrolling everything drawn through Sprite::render.
+ *
+ * @param x The x-coordinate of the top-left corner of the view in pixels.
+ * @param y The y-coordinate of the top-left corner of the view in pixels.
+ */
+void Window::setCamera(int x, int y) {
+    this->camera.x = x;
+    this->camera.y = y;
+}
+
+/**
+ * Gets the position of the camera.
+ *
+ * @return The top-left corner of the view in pixels.
+ */
+SDL_Point Window::getCamera() { return this->camera; }
+
+/**
+ * Sets how far the frame being drawn is between two simulation ticks.
+ *
+ * @param interpolation 0 to draw entities where the last tick started, up to
+ * 1 to draw them where it ended.
+ */
+void Window::setInterpolation(float interpolation) {
+    this->interpolation = interpolation;
+}
+
+/**
+ * Gets how far the frame being drawn is between two simulation ticks.
+ *
+ * @return The interpolation factor, from 0 to 1.
+ */
+float Window::getInterpolation() { return this->interpolation; }
+
+/**
+ * Loads an SDL texture from a specified file path. Textures are cached by path,
+ * so every image is only decoded and uploaded once no matter how many callers
+ * ask for it. Each call must be balanced by a call to releaseTexture.
  *
  * @param filePath The path to the image file.
- * @return The loaded SDL texture.
+ * @return The loaded SDL texture, or NULL if the image could not be loaded.
  */
 SDL_Texture *Window::loadTexture(const char *filePath) {
-    SDL_Texture *texture = NULL;
+    auto it = this->textureCache.find(filePath);
+
+    // Share the texture if it has already been loaded. Images that failed to
+    // load are kept as NULL so they are not decoded again for every caller
+    if (it != this->textureCache.end()) {
+        it->second.refCount++;
+        return it->second.texture;
+    }
 
     /**
      * Loads an SDL texture from the specified file path.
@@ -69,7 +143,7 @@ SDL_Texture *Window::loadTexture(const char *filePath) {
      * @param filePath The path to the image file.
      * @return The loaded SDL texture.
      */
-    texture = IMG_LoadTexture(this->renderer, filePath);
+    SDL_Texture *texture = IMG_LoadTexture(this->renderer, filePath);
 
     // Check if the texture loading was successful
     if (texture == NULL) {
@@ -77,23 +151,114 @@ SDL_Texture *Window::loadTexture(const char *filePath) {
                   << "\n";
     }
 
+    this->textureCache[filePath] = CachedTexture{texture, 1};
+
     return texture;
 }
 
+/**
+ * Gives up one reference to a texture returned by loadTexture. The texture is
+ * destroyed once nothing references it anymore.
+ *
+ * @param texture The texture to release.
+ */
+void Window::releaseTexture(SDL_Texture *texture) {
+    if (texture == NULL)
+        return;
+
+    for (auto it = this->textureCache.begin(); it != this->textureCache.end();
+         it++) {
+        if (it->second.texture != texture) {
+            continue;
+        }
+
+        if (--it->second.refCount <= 0) {
+            SDL_DestroyTexture(it->second.texture);
+            this->textureCache.erase(it);
+        }
+
+        return;
+    }
+}
+
+/**
+ * Loads one of the small in-game sprites. Sprites are served from a single
+ * atlas texture that lives as long as the window, so callers never need to
+ * release them. Images that are not part of the atlas fall back to a texture
+ * of their own from loadTexture. Sprites hold their reference to it for as
+ * long as the window exists, so it is shared but never released before then.
+ *
+ * @param filePath The path to the image file.
+ * @return The texture holding the sprite and the sprite's rectangle within it.
+ */
+TextureRegion Window::loadSprite(const char *filePath) {
+    // Build the atlas on first use, once the renderer is ready
+    if (!this->isAtlasAttempted) {
+        this->isAtlasAttempted = true;
+        this->atlas.build(this->renderer, ATLAS_SPRITES);
+    }
+
+    TextureRegion region;
+    if (this->atlas.getRegion(filePath, &region)) {
+        return region;
+    }
+
+    region.texture = this->loadTexture(filePath);
+    region.rect = SDL_Rect{0, 0, 0, 0};
+    SDL_QueryTexture(region.texture, NULL, NULL, &region.rect.w,
+                     &region.rect.h);
+
+    return region;
+}
+
+/**
+ * Gets the glyphs of the game's font at a given size, rasterizing them the
+ * first time that size is asked for. The atlas lives as long as the window.
+ *
+ * @param fontSize The point size of the font.
+ * @return The glyph atlas, which is empty if it could not be built.
+ */
+GlyphAtlas *Window::getGlyphAtlas(int fontSize) {
+    auto it = this->glyphAtlases.find(fontSize);
+
+    if (it == this->glyphAtlases.end()) {
+        it = this->glyphAtlases.emplace(fontSize, GlyphAtlas()).first;
+        it->second.build(this->renderer, FONT_PATH, fontSize);
+    }
+
+    return &it->second;
+}
+
 /**
  * Clears the renderer, preparing it for the next frame.
  */
 void Window::clear() { SDL_RenderClear(this->renderer); }
 
 /**
- * Presents the renderer, displaying the rendered content.
+ * Draws the sprites batched during the frame, then presents the renderer,
+ * displaying the rendered content.
  */
-void Window::display() { SDL_RenderPresent(this->renderer); }
+void Window::display() {
+    this->spriteBatch.flush(this->renderer);
+    SDL_RenderPresent(this->renderer);
+}
 
 /**
  * Destructor for the Window class, responsible for cleaning up SDL resources.
  */
 Window::~Window() {
-    SDL_DestroyWindow(this->sdlWindow);
+    // Textures belong to the renderer, so free them before it goes away
+    for (auto &entry : this->textureCache) {
+        if (entry.second.texture != NULL) {
+            SDL_DestroyTexture(entry.second.texture);
+        }
+    }
+    this->textureCache.clear();
+    this->atlas.destroy();
+    for (auto &entry : this->glyphAtlases) {
+        entry.second.destroy();
+    }
+
     SDL_DestroyRenderer(this->renderer);
+    SDL_DestroyWindow(this->sdlWindow);
 }
@@ -0,0 +1,115 @@
+// Checks that LevelData::load rejects compiled levels whose header or spawn
+// tables could not be played safely, and still accepts a valid one
+
+#include "Maze/LevelData.hpp"
+#include "Maze/TileGrid.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Where the test levels are written
+const char *TEST_LEVEL_PATH = "/tmp/levelDataTest.lvl";
+
+// Number of checks that failed
+int failures = 0;
+
+/**
+ * Reports a check that did not hold.
+ *
+ * @param isPassed Whether the check held.
+ * @param name What was checked.
+ */
+void check(bool isPassed, const char *name) {
+    printf("%s: %s\n", isPassed ? "pass" : "FAIL", name);
+    if (!isPassed) {
+        failures++;
+    }
+}
+
+/**
+ * Reads a whole file.
+ *
+ * @param filePath The path to the file.
+ * @return The file's bytes.
+ */
+std::vector<unsigned char> readFile(const char *filePath) {
+    std::vector<unsigned char> bytes;
+    FILE *file = fopen(filePath, "rb");
+    int c;
+    while (file != NULL && (c = fgetc(file)) != EOF) {
+        bytes.push_back(c);
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    return bytes;
+}
+
+/**
+ * Writes a level file with part of it changed, and tries to load it.
+ *
+ * @param original The bytes of a valid level file.
+ * @param offset Where in the file to write the change.
+ * @param value The value written there.
+ * @return Whether the changed file loaded.
+ */
+bool loadChanged(std::vector<unsigned char> original, size_t offset,
+                 int32_t value) {
+    memcpy(original.data() + offset, &value, sizeof(value));
+
+    FILE *file = fopen(TEST_LEVEL_PATH, "wb");
+    fwrite(original.data(), 1, original.size(), file);
+    fclose(file);
+
+    LevelData data;
+    return data.load(TEST_LEVEL_PATH);
+}
+
+int main() {
+    LevelData level;
+    level.map = TileGrid(8, 8);
+    level.map.setWall(0, 0, true);
+    level.player = LevelSpawn{1, 1};
+    level.keys.push_back(LevelSpawn{2, 3});
+    level.followers.push_back(LevelSpawn{6, 6});
+
+    check(level.save(TEST_LEVEL_PATH), "valid level saves");
+
+    LevelData loaded;
+    check(loaded.load(TEST_LEVEL_PATH), "valid level loads");
+
+    std::vector<unsigned char> bytes = readFile(TEST_LEVEL_PATH);
+    size_t keyOffset = sizeof(LevelFileHeader);
+    size_t followerOffset = keyOffset + sizeof(LevelSpawn);
+
+    // Both sides are allowed on their own, but not the number of tiles. The
+    // file has a complete chunk table of open chunks, so nothing but the size
+    // is wrong with it
+    int32_t side = 1 << 16;
+    int32_t chunksPerSide = side >> TileGrid::CHUNK_SHIFT;
+    std::vector<unsigned char> huge(bytes.begin(),
+                                    bytes.begin() + followerOffset +
+                                        sizeof(LevelSpawn));
+    huge.resize((huge.size() + 7) & ~size_t(7));
+    huge.resize(huge.size() + size_t(chunksPerSide) * chunksPerSide * 4, 0xff);
+    memcpy(huge.data() + offsetof(LevelFileHeader, width), &side, 4);
+    memset(huge.data() + offsetof(LevelFileHeader, chunkCount), 0, 4);
+    check(!loadChanged(huge, offsetof(LevelFileHeader, height), side),
+          "65536x65536 level is rejected");
+
+    check(!loadChanged(bytes, offsetof(LevelFileHeader, playerX), 8),
+          "player off the map is rejected");
+    check(!loadChanged(bytes, offsetof(LevelFileHeader, playerY), -1),
+          "missing player is rejected");
+    check(!loadChanged(bytes, keyOffset, 1 << 28),
+          "key off the map is rejected");
+    check(!loadChanged(bytes, followerOffset + 4, -5),
+          "follower off the map is rejected");
+    check(!loadChanged(bytes, offsetof(LevelFileHeader, keyCount), 1 << 30),
+          "key table past the end of the file is rejected");
+
+    remove(TEST_LEVEL_PATH);
+
+    return failures == 0 ? 0 : 1;
+}
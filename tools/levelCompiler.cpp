@@ -0,0 +1,42 @@
+// Compiles text levels into the binary format loaded by the game. Each
+// level is written next to its source with the extension changed to .lvl
+
+#include "Maze/LevelData.hpp"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("Usage: %s LEVEL.txt...\n", argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string sourcePath = argv[i];
+        std::string outputPath = sourcePath;
+
+        size_t extension = outputPath.rfind('.');
+        if (extension != std::string::npos &&
+            outputPath.find('/', extension) == std::string::npos) {
+            outputPath.erase(extension);
+        }
+        outputPath += ".lvl";
+
+        LevelData level;
+        if (!level.loadText(sourcePath.c_str()) ||
+            !level.save(outputPath.c_str())) {
+            failures++;
+            continue;
+        }
+
+        printf("%s -> %s (%dx%d, %d keys, %d followers, %d wall chunks)\n",
+               sourcePath.c_str(), outputPath.c_str(), level.map.getWidth(),
+               level.map.getHeight(), int(level.keys.size()),
+               int(level.followers.size()),
+               level.map.getAllocatedChunkCount());
+    }
+
+    return failures == 0 ? 0 : 1;
+}